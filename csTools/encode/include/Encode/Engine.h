@@ -118,6 +118,16 @@ namespace Encode {
       return ::Encode::compose(_fields, store);
     }
 
+    void decompose(Store& store, const value_type word) const
+    {
+      ::Encode::decompose(store, _fields, word);
+    }
+
+    const List& fields() const
+    {
+      return _fields;
+    }
+
     size_type initialize(Store& store,
                          const value_type initValue = 0,
                          const bool keep_values = false) const
@@ -125,6 +135,11 @@ namespace Encode {
       return ::Encode::initialize(store, _fields, initValue, keep_values);
     }
 
+    bool isMatch(const value_type word) const
+    {
+      return ::Encode::isMatch(_fields, word);
+    }
+
     static EnginePtr<value_type> make(const size_type numBits,
                                       const std::string_view& text)
     {
@@ -69,9 +69,9 @@ namespace Encode {
           : cs::NUM_BITS<value_type>;
 
       const bool is_range =
-          0 <= _from  &&  _from < maxRange  &&
-          0 <= _to    &&  _to   < maxRange  &&
-          0 <= _at    &&  _at   < maxRange;
+          _from < maxRange  &&
+          _to   < maxRange  &&
+          _at   < maxRange;
 
       const size_t is_pos =
           _from <= _to  &&
@@ -92,6 +92,21 @@ namespace Encode {
       return ((x >> _from) & mask) << _at;
     }
 
+    // NOTE: extract() is the inverse of value(): it moves the bits at '_at'
+    //       of 'word' back to their origin '_from'.
+
+    virtual value_type extract(const value_type word) const
+    {
+      const T mask = cs::makeBitMask<T>(_to - _from + 1);
+
+      return ((word >> _at) & mask) << _from;
+    }
+
+    virtual bool isMatch(const value_type /*word*/) const
+    {
+      return true;
+    }
+
   protected:
     IField(const size_t from, const size_t to,
            const size_t at) noexcept
@@ -56,6 +56,37 @@ namespace Encode {
     return value;
   }
 
+  // NOTE: decompose() ORs the fields' bits of 'word' into an initialized store.
+
+  template<typename T>
+  inline void decompose(VariableStore<T>& store, const FieldList<T>& fields, const T word)
+  {
+    for(const FieldPtr<T>& field : fields) {
+      if( !field ) {
+        continue;
+      }
+
+      const std::string name = field->name();
+      if( name.empty() ) {
+        continue;
+      }
+
+      store[name] |= field->extract(word);
+    }
+  }
+
+  template<typename T>
+  inline bool isMatch(const FieldList<T>& fields, const T word)
+  {
+    for(const FieldPtr<T>& field : fields) {
+      if( field  &&  !field->isMatch(word) ) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   template<typename T>
   inline size_t initialize(VariableStore<T>& store, const FieldList<T>& fields,
                            const T initValue = 0, const bool keep_values = false)
@@ -63,6 +63,11 @@ namespace Encode {
       return IField<T>::value(_value);
     }
 
+    bool isMatch(const value_type word) const
+    {
+      return IField<T>::extract(word) == IField<T>::extract(value(0));
+    }
+
     static FieldPtr<T> make(const T value,
                             const size_t from, const size_t to,
                             const size_t at = 0)
@@ -97,6 +97,15 @@ void test_engine(const Encode::EnginePtr<uint32_t>& engine)
   const value_type value = engine->compose(store);
   std::println("{0}: 0x{1:0{2}X}", engine->text(), value, sizeof(value_type)*2);
 
+  // NOTE: Only the bits covered by the fields are recovered.
+  Store decoded;
+  engine->initialize(decoded);
+  engine->decompose(decoded, value);
+  for(const Store::value_type& entry : decoded) {
+    std::println("{} == 0x{:X}", entry.first, entry.second);
+  }
+  std::println("Literals match: {}", engine->isMatch(value));
+
   std::println();
 }
 
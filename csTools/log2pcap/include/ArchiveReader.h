@@ -0,0 +1,106 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <vector>
+
+#include <cs/Core/ByteArray.h>
+
+#include "CanArchive.h"
+#include "FrameFilter.h"
+#include "LineInfo.h"
+#include "MappedFile.h"
+
+/*
+ * NOTE: ArchiveReader maps a CAN archive into memory and decodes its frames
+ *       into LineInfos. Blocks whose time range or ID bitmaps cannot match
+ *       the filter are skipped without decoding them; the remaining frames
+ *       are checked by the filter one by one.
+ *
+ * NOTE: The filter is referenced and must outlive the reader's use of it.
+ */
+
+class ArchiveReader {
+public:
+  using size_type = std::size_t;
+
+  ArchiveReader() noexcept;
+  ~ArchiveReader() noexcept;
+
+  void close();
+  bool isError() const;
+  bool isOpen() const;
+  bool open(const std::filesystem::path& path);
+
+  size_type numBlocks() const;
+  size_type numBlocksRead() const;
+  size_type numFrames() const;
+
+  void setFilter(const FrameFilter *filter);
+
+  bool getInfo(LineInfo& info);
+
+private:
+  struct Column {
+    const cs::byte_t *first{nullptr};
+    const cs::byte_t *last{nullptr};
+  };
+
+  ArchiveReader(const ArchiveReader&) noexcept = delete;
+  ArchiveReader& operator=(const ArchiveReader&) noexcept = delete;
+
+  bool acceptBlock(const canarc_block& block) const;
+  bool decodeFrame(LineInfo& info, const cs::byte_t*& data);
+  bool nextBlock();
+
+  std::vector<canarc_block> _blocks;
+  Column                    _data;
+  Column                    _device;
+  std::vector<DeviceId>     _devices;
+  uint64_t                  _effQuery[CANARC_BITMAP_WORDS]{};
+  MappedFile                _file;
+  const FrameFilter        *_filter{nullptr};
+  Column                    _flags;
+  Column                    _id;
+  size_type                 _idxBlock{0};
+  bool                      _is_anyId{true};
+  bool                      _is_error{false};
+  int64_t                   _lastTime{0};
+  size_type                 _numBlocksRead{0};
+  size_type                 _numLeft{0};
+  uint64_t                  _sffQuery[CANARC_BITMAP_WORDS]{};
+  Column                    _time;
+};
@@ -0,0 +1,92 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+#include <cs/Core/ByteArray.h>
+
+#include "BufferedFile.h"
+#include "CanArchive.h"
+#include "IFrameSink.h"
+
+/*
+ * NOTE: ArchiveSink writes all frames to a CAN archive (cf. CanArchive.h);
+ *       the frames of a block are collected column by column and written
+ *       once the block is full. The device table and the directory of all
+ *       blocks are written on close().
+ */
+
+class ArchiveSink : public IFrameSink {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BLOCK_FRAMES = 4096;
+
+  ~ArchiveSink();
+
+  bool close();
+  bool flush();
+  size_type numFrames() const;
+  bool write(const LineInfo& info);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const size_type blockFrames = DEFAULT_BLOCK_FRAMES);
+
+private:
+  using Column = std::vector<cs::byte_t>;
+
+  ArchiveSink() = delete;
+  ArchiveSink(const size_type blockFrames);
+
+  uint32_t deviceIndex(const DeviceId device);
+  bool writeBlock();
+
+  canarc_block                           _block{};
+  size_type                              _blockFrames{DEFAULT_BLOCK_FRAMES};
+  std::vector<canarc_block>              _blocks;
+  Column                                 _data;
+  Column                                 _device;
+  std::unordered_map<DeviceId,uint32_t>  _deviceIndex;
+  std::vector<DeviceId>                  _devices;
+  BufferedFile                           _file;
+  Column                                 _flags;
+  Column                                 _id;
+  int64_t                                _lastTime{0};
+  size_type                              _numFrames{0};
+  Column                                 _time;
+};
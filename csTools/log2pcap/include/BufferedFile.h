@@ -0,0 +1,78 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <filesystem>
+#include <vector>
+
+#include <cs/Core/ByteArray.h>
+#include <cs/IO/File.h>
+
+/*
+ * NOTE: BufferedFile collects data in a staging buffer, which is written to
+ *       the file in one block once it is full. Data may be serialized in
+ *       place by reserve()ing space and commit()ing the bytes actually used.
+ *       Any error is sticky!
+ */
+
+class BufferedFile {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BUFFER_SIZE = 1024*1024;
+
+  BufferedFile(const size_type bufferSize = DEFAULT_BUFFER_SIZE) noexcept;
+  ~BufferedFile() noexcept;
+
+  bool close();
+  bool flush();
+  bool isOpen() const;
+  bool open(const std::filesystem::path& path);
+  size_type position() const;
+
+  cs::byte_t *reserve(const size_type size);
+  void commit(const size_type size);
+
+  bool write(const void *data, const size_type size);
+
+private:
+  BufferedFile(const BufferedFile&) noexcept = delete;
+  BufferedFile& operator=(const BufferedFile&) noexcept = delete;
+
+  std::vector<cs::byte_t> _buffer;
+  cs::File                _file;
+  bool                    _is_error{false};
+  size_type               _position{0};
+  size_type               _used{0};
+};
@@ -0,0 +1,151 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "DeviceTable.h"
+#include "LineInfo.h"
+#include "SocketCAN.h"
+
+/*
+ * NOTE: BusStatistics accumulates per-device and per-ID statistics of a
+ *       stream of frames in a single pass; no frame is stored.
+ *
+ * NOTE: Per-ID statistics are kept in fixed-size tables: 11-bit IDs are
+ *       indexed directly, 29-bit IDs are hashed using open addressing.
+ *
+ * NOTE: The jitter of an ID is the absolute difference of two consecutive
+ *       inter-arrival times; its histogram has logarithmic bins, where bin
+ *       'k > 0' counts differences in [2^(k-1),2^k) microseconds.
+ *
+ * NOTE: The bus load is estimated from the nominal length of each frame
+ *       (excluding stuff bits) at the configured bitrates and accumulated
+ *       per second of the time stamps.
+ */
+
+struct BusTiming {
+  uint32_t bitrate{500000};
+  uint32_t dataBitrate{2000000};
+};
+
+class BusStatistics {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type NUM_DLC_BINS    = 16;
+  static constexpr size_type NUM_JITTER_BINS = 24;
+
+  static constexpr int64_t NO_TIME = std::numeric_limits<int64_t>::min();
+
+  struct IdStats {
+    double meanGap() const;
+
+    canid_t  id{0};            // including CAN_EFF_FLAG
+    uint64_t count{0};
+    uint64_t numGaps{0};
+    int64_t  last{NO_TIME};
+    int64_t  prevGap{-1};
+    int64_t  minGap{std::numeric_limits<int64_t>::max()};
+    int64_t  maxGap{0};
+    int64_t  sumGap{0};
+    std::array<uint32_t,NUM_DLC_BINS>    dlc{};
+    std::array<uint32_t,NUM_JITTER_BINS> jitter{};
+  };
+
+  class IdTable {
+  public:
+    IdTable() noexcept;
+    ~IdTable() noexcept;
+
+    IdStats& get(const canid_t id);
+
+    std::vector<const IdStats*> sorted() const;
+
+  private:
+    static constexpr size_type MIN_HASHED = 1024;
+
+    IdStats& getHashed(const canid_t id);
+    void rehash(const size_type capacity);
+
+    std::unique_ptr<IdStats[]> _direct;
+    std::vector<IdStats>       _hashed;
+    size_type                  _numHashed{0};
+  };
+
+  struct DeviceStats {
+    double busyTime() const;
+    double meanLoad() const;
+    double maxLoad() const;
+
+    DeviceId                 device{INVALID_DEVICE};
+    uint64_t                 count{0};
+    uint64_t                 countFD{0};
+    uint64_t                 countExt{0};
+    uint64_t                 countRtr{0};
+    uint64_t                 countReordered{0};
+    int64_t                  first{NO_TIME};
+    int64_t                  last{NO_TIME};
+    std::map<int64_t,double> busy; // busy time [s] per second
+    IdTable                  ids;
+    double                  *lastBusy{nullptr};
+    int64_t                  lastSecond{NO_TIME};
+  };
+
+  using Devices = std::map<DeviceId,DeviceStats>;
+
+  BusStatistics(const BusTiming& timing = BusTiming()) noexcept;
+  ~BusStatistics() noexcept;
+
+  void add(const LineInfo& info);
+
+  const Devices& devices() const;
+  const BusTiming& timing() const;
+
+  static uint8_t dlc(const LineInfo& info);
+
+  static double duration(const LineInfo& info, const BusTiming& timing);
+
+private:
+  DeviceStats& device(const DeviceId id);
+
+  Devices      _devices;
+  DeviceStats *_lastDevice{nullptr};
+  BusTiming    _timing;
+};
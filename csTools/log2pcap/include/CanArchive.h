@@ -0,0 +1,161 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SocketCAN.h"
+
+/*
+ * NOTE: A CAN archive stores parsed frames column by column in blocks of
+ *       'block_frames' consecutive frames. Each block keeps five columns:
+ *
+ *       time   - zig-zag varint delta to the previous timestamp [us]
+ *       id     - varint of the bare CAN ID
+ *       flags  - flags byte, 'len' and, if CANARC_FLAG_LEN8, 'len8_dlc'
+ *       device - varint index into the archive's device table
+ *       data   - 'len' bytes of payload of every non-RTR frame
+ *
+ * NOTE: The directory at the end of the archive lists every block along
+ *       with the range of its timestamps and bitmaps of its CAN IDs; hence
+ *       blocks are skipped without decoding them. The bitmap of standard
+ *       IDs is exact; extended IDs are hashed and may yield false positives.
+ *
+ * NOTE: The timestamps of a log need not be monotonic; the first delta of
+ *       a block refers to the block's 'time_first'.
+ *
+ * Archive Layout (little endian):
+ *
+ * canarc_hdr
+ * columns of block 0 ... columns of block N-1
+ * device table: [uint16_t length, char name[length]][num_devices]
+ * canarc_block[num_blocks]
+ * canarc_trailer
+ */
+
+inline constexpr std::size_t CANARC_BITMAP_WORDS = 32;
+
+#pragma pack(push,1)
+
+struct canarc_hdr {
+  uint32_t magic_number;   /* magic number */
+  uint16_t version_major;  /* major version number */
+  uint16_t version_minor;  /* minor version number */
+  uint32_t block_frames;   /* max. frames per block */
+  uint32_t reserved;       /* reserved, must be zero */
+};
+
+struct canarc_block {
+  uint64_t offset;         /* file offset of the block's first column */
+  uint32_t count;          /* number of frames */
+  uint32_t size_time;      /* size of time column, in octets */
+  uint32_t size_id;        /* size of ID column, in octets */
+  uint32_t size_flags;     /* size of flags column, in octets */
+  uint32_t size_device;    /* size of device column, in octets */
+  uint32_t size_data;      /* size of data column, in octets */
+  int64_t  time_first;     /* timestamp of first frame [us] */
+  int64_t  time_min;       /* earliest timestamp [us] */
+  int64_t  time_max;       /* latest timestamp [us] */
+  uint64_t reserved;       /* reserved, must be zero */
+  uint64_t sff_bitmap[CANARC_BITMAP_WORDS]; /* standard IDs */
+  uint64_t eff_bitmap[CANARC_BITMAP_WORDS]; /* hashed extended IDs */
+};
+
+struct canarc_trailer {
+  uint64_t offset_devices; /* file offset of device table */
+  uint64_t num_devices;    /* number of devices */
+  uint64_t offset_blocks;  /* file offset of directory */
+  uint64_t num_blocks;     /* number of blocks */
+  uint32_t magic_number;   /* magic number */
+  uint32_t reserved;       /* reserved, must be zero */
+};
+
+#pragma pack(pop)
+
+static_assert( sizeof(canarc_hdr)     ==  16 );
+static_assert( sizeof(canarc_block)   == 576 );
+static_assert( sizeof(canarc_trailer) ==  40 );
+
+inline constexpr uint32_t CANARC_MAGIC_NUMBER = 0x52414C43; // "CLAR"
+
+inline constexpr uint16_t CANARC_VERSION_MAJOR = 1;
+inline constexpr uint16_t CANARC_VERSION_MINOR = 0;
+
+inline constexpr uint8_t CANARC_FLAG_CANFD = 0x01;
+inline constexpr uint8_t CANARC_FLAG_EXT   = 0x02;
+inline constexpr uint8_t CANARC_FLAG_RTR   = 0x04;
+inline constexpr uint8_t CANARC_FLAG_LEN8  = 0x08;
+
+// NOTE: The upper nibble of the flags byte holds the CAN FD flags.
+inline constexpr uint8_t CANARC_FDFLAGS_SHIFT = 4;
+
+////// Bitmaps ///////////////////////////////////////////////////////////////
+
+inline constexpr std::size_t CANARC_BITMAP_BITS = CANARC_BITMAP_WORDS*64;
+
+static_assert( CANARC_BITMAP_BITS == CAN_SFF_MASK + 1 );
+
+inline std::size_t canarcSffBit(const canid_t id)
+{
+  return id & CAN_SFF_MASK;
+}
+
+inline std::size_t canarcEffBit(const canid_t id)
+{
+  // NOTE: Fibonacci hashing; the upper 11 bits index the bitmap.
+  return static_cast<uint32_t>((id & CAN_EFF_MASK)*0x9E3779B1u) >> 21;
+}
+
+inline void canarcSetBit(uint64_t *bitmap, const std::size_t bit)
+{
+  bitmap[bit/64] |= uint64_t{1} << (bit%64);
+}
+
+inline bool canarcTestBit(const uint64_t *bitmap, const std::size_t bit)
+{
+  return (bitmap[bit/64] & (uint64_t{1} << (bit%64))) != 0;
+}
+
+////// Varints ///////////////////////////////////////////////////////////////
+
+// NOTE: Zig-zag encoding maps small negative deltas to small varints.
+
+inline uint64_t canarcZigZag(const int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t canarcUnZigZag(const uint64_t value)
+{
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LineInfo.h"
+
+namespace candump {
+
+  // NOTE: Upper bound of a formatted line, excluding the device's name.
+  inline constexpr std::size_t MAX_LINE_SIZE = 192;
+
+  /*
+   * NOTE: Render 'info' as a candump log line including its line ending;
+   *       'dest' must hold at least MAX_LINE_SIZE + device.size() chars.
+   *       The return value is the number of chars written.
+   */
+
+  std::size_t format(char *dest, const LineInfo& info, const std::string_view& device);
+
+} // namespace candump
+
+/*
+ * NOTE: CandumpWriter formats frames into a large buffer, which is written
+ *       to 'stream' once full, upon flush() and upon destruction.
+ */
+
+class CandumpWriter {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BUFFER_SIZE = 1024*1024;
+
+  CandumpWriter(std::FILE *stream, const size_type bufferSize = DEFAULT_BUFFER_SIZE) noexcept;
+  ~CandumpWriter() noexcept;
+
+  bool flush();
+  bool write(const LineInfo& info);
+
+private:
+  CandumpWriter() noexcept = delete;
+  CandumpWriter(const CandumpWriter&) noexcept = delete;
+  CandumpWriter& operator=(const CandumpWriter&) noexcept = delete;
+
+  std::vector<char>  _buffer;
+  DeviceId           _device{INVALID_DEVICE};
+  const std::string *_name{nullptr};
+  size_type          _size{0};
+  std::FILE         *_stream{nullptr};
+};
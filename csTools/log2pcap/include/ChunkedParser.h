@@ -0,0 +1,99 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <deque>
+#include <future>
+#include <string_view>
+
+#include "FrameStore.h"
+#include "LineInfo.h"
+#include "ParseErrors.h"
+#include "Parser.h"
+
+/*
+ * NOTE: ChunkedParser splits an in-memory text into newline-aligned chunks,
+ *       which are parsed concurrently. The parsed frames are handed out in
+ *       their original order; at most 2*numThreads chunks are in flight.
+ *       Each parsed chunk is held in a compact FrameStore.
+ *
+ * NOTE: Each chunk knows its first line number, so messages added to
+ *       'errors' by the parser refer to the correct line.
+ */
+
+class ChunkedParser {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_CHUNK_SIZE = 1024*1024;
+
+  ChunkedParser(const std::string_view& text, ParseErrors& errors,
+                const size_type numThreads = 0,
+                const parser::ParseFunc parse = parser::parseLine,
+                const FrameFilter *filter = nullptr,
+                const size_type chunkSize = DEFAULT_CHUNK_SIZE) noexcept;
+  ~ChunkedParser() noexcept;
+
+  bool getInfo(LineInfo& info);
+
+  static size_type defaultThreads();
+
+  static std::string_view nextChunk(const std::string_view& text, size_type& pos,
+                                    const size_type chunkSize);
+
+  static FrameStore parseChunk(const std::string_view& chunk, const size_type lineno,
+                               ParseErrors& errors, const parser::ParseFunc parse,
+                               const FrameFilter *filter);
+
+private:
+  using Infos  = FrameStore;
+  using Result = std::future<Infos>;
+
+  ChunkedParser(const ChunkedParser&) noexcept = delete;
+  ChunkedParser& operator=(const ChunkedParser&) noexcept = delete;
+
+  bool dispatch();
+
+  size_type             _chunkSize{DEFAULT_CHUNK_SIZE};
+  ParseErrors&          _errors;
+  const FrameFilter    *_filter{nullptr};
+  Infos                 _infos;
+  Infos::const_iterator _iter;
+  size_type             _lineno{0};
+  size_type             _maxPending{0};
+  parser::ParseFunc     _parse{nullptr};
+  std::deque<Result>    _pending;
+  size_type             _pos{0};
+  std::string_view      _text;
+};
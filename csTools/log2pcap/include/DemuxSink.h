@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+#include <cs/Logging/Logger.h>
+
+#include "IFrameSink.h"
+
+/*
+ * NOTE: DemuxSink routes each frame to the pcap file of its device; the
+ *       files are created on first use and named "<stem>_<device>.pcap".
+ */
+
+class DemuxSink : public IFrameSink {
+public:
+  ~DemuxSink();
+
+  bool close();
+  bool flush();
+  std::size_t numFrames() const;
+  bool write(const LineInfo& info);
+
+  static std::filesystem::path outputPath(const std::filesystem::path& output,
+                                          const std::string& device);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const cs::LoggerPtr& logger,
+                              const bool index = false);
+
+private:
+  using Sinks = std::map<DeviceId,IFrameSinkPtr>;
+
+  DemuxSink() = delete;
+  DemuxSink(const std::filesystem::path& output, const cs::LoggerPtr& logger,
+            const bool index);
+
+  IFrameSink *sink(const DeviceId device);
+
+  DeviceId              _lastDevice{INVALID_DEVICE};
+  bool                  _index{false};
+  IFrameSink           *_lastSink{nullptr};
+  cs::LoggerPtr         _logger;
+  std::size_t           _numFrames{0};
+  std::filesystem::path _output;
+  Sinks                 _sinks;
+};
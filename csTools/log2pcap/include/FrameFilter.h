@@ -0,0 +1,92 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <cs/System/Time.h>
+
+#include "DeviceTable.h"
+#include "LineInfo.h"
+#include "SocketCAN.h"
+
+/*
+ * NOTE: FrameFilter decides which frames are converted; it is evaluated by
+ *       the parser as early as possible, i.e. before any payload is decoded.
+ *       Rejected lines are skipped silently and are not validated further!
+ *
+ * NOTE: ID filters follow the semantics of SocketCAN's 'can_filter': a frame
+ *       passes if (can_id & can_mask) == (filter.can_id & can_mask), where
+ *       can_id includes CAN_EFF_FLAG and CAN_RTR_FLAG; CAN_INV_FILTER in the
+ *       filter's can_id inverts the match. ID ranges match the bare ID.
+ *       A frame passes if it matches any ID filter or range.
+ *
+ * NOTE: The time window is [from,to); an invalid bound is unbounded.
+ */
+
+class FrameFilter {
+public:
+  using Range = std::pair<canid_t,canid_t>;
+
+  FrameFilter() noexcept;
+  ~FrameFilter() noexcept;
+
+  bool isEmpty() const;
+
+  void addDevice(const std::string_view& name);
+  void addId(const canid_t can_id, const canid_t can_mask);
+  bool addId(const std::string_view& spec);
+  void addRange(const canid_t first, const canid_t last);
+  void setWindow(const cs::TimeVal& from, const cs::TimeVal& to);
+
+  bool acceptDevice(const DeviceId device) const;
+  bool acceptId(const canid_t can_id) const;
+  bool acceptTime(const cs::TimeVal& time) const;
+
+  bool accept(const LineInfo& info) const;
+
+  const std::vector<can_filter>& filters() const;
+  const cs::TimeVal& from() const;
+  const std::vector<Range>& ranges() const;
+  const cs::TimeVal& to() const;
+
+  static canid_t canId(const LineInfo& info);
+
+private:
+  std::vector<DeviceId>   _devices;
+  std::vector<can_filter> _filters;
+  cs::TimeVal             _from{-1};
+  std::vector<Range>      _ranges;
+  cs::TimeVal             _to{-1};
+};
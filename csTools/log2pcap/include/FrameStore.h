@@ -0,0 +1,214 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <cs/Core/ByteArray.h>
+
+#include "LineInfo.h"
+
+/*
+ * NOTE: FrameStore packs frames contiguously into large blocks of memory;
+ *       each record consists of a fixed FrameHeader followed by only 'len'
+ *       bytes of payload, padded to an 8-byte boundary. A classic CAN frame
+ *       with 8 bytes of payload occupies 32 bytes.
+ *
+ * NOTE: Records never span blocks; appending never moves existing records.
+ */
+
+struct FrameHeader {
+  enum Flags : uint8_t {
+    FLAG_CANFD = 0x01,
+    FLAG_EXT   = 0x02,
+    FLAG_RTR   = 0x04
+  };
+
+  int64_t  time;
+  canid_t  id;
+  DeviceId device;
+  uint8_t  len;
+  uint8_t  len8_dlc;
+  uint8_t  fdflags;
+  uint8_t  flags;
+};
+
+static_assert( sizeof(FrameHeader) == 24 );
+
+class FrameView {
+public:
+  FrameView(const FrameHeader *header = nullptr) noexcept
+    : _header{header}
+  {
+  }
+
+  inline const cs::byte_t *data() const
+  {
+    return reinterpret_cast<const cs::byte_t*>(_header + 1);
+  }
+
+  inline DeviceId device() const
+  {
+    return _header->device;
+  }
+
+  inline canid_t id() const
+  {
+    return _header->id;
+  }
+
+  inline bool isCanFD() const
+  {
+    return (_header->flags & FrameHeader::FLAG_CANFD) != 0;
+  }
+
+  inline bool isExt() const
+  {
+    return (_header->flags & FrameHeader::FLAG_EXT) != 0;
+  }
+
+  inline bool isRtr() const
+  {
+    return (_header->flags & FrameHeader::FLAG_RTR) != 0;
+  }
+
+  inline uint8_t len() const
+  {
+    return _header->len;
+  }
+
+  inline cs::TimeVal time() const
+  {
+    return cs::TimeVal{_header->time};
+  }
+
+  void get(LineInfo& info) const;
+
+  LineInfo toInfo() const;
+
+private:
+  const FrameHeader *_header{nullptr};
+};
+
+class FrameStore {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BLOCK_SIZE = 1024*1024;
+
+  class const_iterator {
+  public:
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = FrameView;
+    using pointer           = const FrameView*;
+    using reference         = FrameView;
+
+    const_iterator() noexcept = default;
+
+    inline FrameView operator*() const
+    {
+      return FrameView(header());
+    }
+
+    const_iterator& operator++();
+
+    inline const_iterator operator++(int)
+    {
+      const_iterator result = *this;
+      operator++();
+      return result;
+    }
+
+    inline bool operator==(const const_iterator& other) const
+    {
+      return _idxBlock == other._idxBlock  &&  _offset == other._offset;
+    }
+
+  private:
+    friend class FrameStore;
+
+    const_iterator(const FrameStore *store, const size_type idxBlock) noexcept
+      : _idxBlock{idxBlock}
+      , _store{store}
+    {
+    }
+
+    const FrameHeader *header() const;
+
+    size_type         _idxBlock{0};
+    size_type         _offset{0};
+    const FrameStore *_store{nullptr};
+  };
+
+  FrameStore(const size_type blockSize = DEFAULT_BLOCK_SIZE) noexcept;
+  ~FrameStore() noexcept;
+
+  FrameStore(FrameStore&&) noexcept = default;
+  FrameStore& operator=(FrameStore&&) noexcept = default;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  void clear();
+  bool empty() const;
+  size_type size() const;
+
+  size_type capacityBytes() const;
+  size_type usedBytes() const;
+
+  // NOTE: The returned view remains valid until clear() or destruction.
+  FrameView push_back(const LineInfo& info);
+
+  static size_type recordSize(const uint8_t len);
+
+private:
+  struct Block {
+    std::unique_ptr<uint64_t[]> data;
+    size_type                   used{0};
+  };
+
+  FrameStore(const FrameStore&) noexcept = delete;
+  FrameStore& operator=(const FrameStore&) noexcept = delete;
+
+  cs::byte_t *allocate(const size_type size);
+
+  size_type          _blockSize{DEFAULT_BLOCK_SIZE};
+  std::vector<Block> _blocks;
+  size_type          _numBlocks{0};
+  size_type          _numFrames{0};
+};
@@ -0,0 +1,101 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <cs/IO/File.h>
+
+namespace impl_input {
+  class Decoder;
+} // namespace impl_input
+
+/*
+ * NOTE: InputFile reads a plain, gzip or zstd compressed file; compression
+ *       is detected by the file's magic number, not its extension. Compressed
+ *       input is decompressed block by block while reading, i.e. without a
+ *       temporary copy of the decompressed file.
+ *
+ * NOTE: Decompression is available if log2pcap is built with zlib (gzip)
+ *       and/or libzstd (zstd), respectively; see isSupported().
+ *
+ * NOTE: Concatenated gzip members and zstd frames are read as one stream.
+ *       Corrupt or truncated compressed input ends reading and sets isError().
+ */
+
+class InputFile {
+public:
+  enum class Compression {
+    None = 0,
+    Gzip,
+    Zstd
+  };
+
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BLOCK_SIZE = 256*1024;
+
+  InputFile(const size_type blockSize = DEFAULT_BLOCK_SIZE) noexcept;
+  ~InputFile() noexcept;
+
+  void close();
+  Compression compression() const;
+  bool isError() const;
+  bool isOpen() const;
+  bool open(const std::filesystem::path& path);
+  size_type read(void *data, const size_type size);
+  size_type size() const;
+
+  static Compression detect(const std::filesystem::path& path);
+  static bool isSupported(const Compression compression);
+
+private:
+  InputFile(const InputFile&) noexcept = delete;
+  InputFile& operator=(const InputFile&) noexcept = delete;
+
+  bool fill();
+  size_type readCompressed(char *data, const size_type size);
+  size_type readPlain(char *data, const size_type size);
+
+  std::vector<char>                    _block;
+  Compression                          _compression{Compression::None};
+  std::unique_ptr<impl_input::Decoder> _decoder;
+  bool                                 _eof{false};
+  cs::File                             _file;
+  size_type                            _first{0};
+  bool                                 _is_error{false};
+  size_type                            _last{0};
+};
@@ -0,0 +1,61 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <string_view>
+
+#include "FrameFilter.h"
+#include "LineInfo.h"
+#include "ParseErrors.h"
+
+namespace lexer {
+
+  /*
+   * NOTE: lexLine() is a drop-in replacement for parser::parseLine(); it
+   *       extracts all fields of a candump line in a single forward sweep
+   *       and reports the same messages as the parser.
+   *
+   * Grammar:
+   *
+   * Line      = '(' digits '.' digits ')' { ' ' } Device ' ' { ' ' } Id '#' Message [ RawDLC ] .
+   * Message   = [ '#' hex Data | 'R' [ hex ] | Data ] .
+   * Data      = { hex hex } .
+   * RawDLC    = '_' hex .
+   */
+
+  LineInfo lexLine(const std::string_view& line,
+                   ParseErrors& errors, const std::size_t lineno,
+                   const FrameFilter *filter = nullptr);
+
+} // namespace lexer
@@ -0,0 +1,70 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <cs/Core/ByteArray.h>
+#include <cs/System/Time.h>
+
+#include "DeviceTable.h"
+#include "SocketCAN.h"
+
+using LineData = cs::ByteArray<CANFD_MAX_DLEN>;
+
+struct LineInfo {
+  LineInfo()
+  {
+    data.fill(0);
+  }
+
+  bool isValid() const
+  {
+    return device != INVALID_DEVICE  &&  time.isValid();
+  }
+
+  bool isLen8Dlc() const
+  {
+    return !is_canfd  &&  len == 8  &&  len8_dlc > 8;
+  }
+
+  LineData    data;
+  DeviceId    device{INVALID_DEVICE};
+  uint8_t     fdflags{0};
+  canid_t     id{0};
+  bool        is_canfd{false};
+  bool        is_ext{false};
+  bool        is_rtr{false};
+  uint8_t     len{0};
+  uint8_t     len8_dlc{0};
+  cs::TimeVal time{-1};
+};
@@ -0,0 +1,98 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "InputFile.h"
+
+/*
+ * NOTE: LineReader reads the input in blocks of fixed size and hands out
+ *       one line at a time; memory use is bounded by the block size (or
+ *       the longest line), independent of the size of the input.
+ *
+ * NOTE: A std::string_view returned by getLine() is valid until the next
+ *       call to getLine()!
+ *
+ * NOTE: In follow mode, a trailing line without ending is held back until
+ *       its ending is written; getLine() then returns false at the end of
+ *       the input, but may be called again once the input has grown.
+ *       offset() is the file offset past the last line handed out.
+ *
+ * NOTE: Compressed input is decompressed while reading (cf. InputFile);
+ *       offset() then refers to the decompressed input and isTruncated()
+ *       does not apply. isError() denotes corrupt compressed input.
+ */
+
+class LineReader {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BLOCK_SIZE = 1024*1024;
+
+  LineReader(const size_type blockSize = DEFAULT_BLOCK_SIZE) noexcept;
+  ~LineReader() noexcept;
+
+  void close();
+  bool isError() const;
+  bool isOpen() const;
+  bool open(const std::filesystem::path& path);
+
+  bool getLine(std::string& line);
+  bool getLine(std::string_view& line);
+  size_type lineNo() const;
+
+  bool isFollow() const;
+  bool isTruncated() const;
+  size_type offset() const;
+  void setFollow(const bool on);
+
+private:
+  LineReader(const LineReader&) noexcept = delete;
+  LineReader& operator=(const LineReader&) noexcept = delete;
+
+  bool fill();
+
+  std::vector<char> _buffer;
+  bool              _eof{false};
+  InputFile         _file;
+  size_type         _first{0};
+  bool              _follow{false};
+  size_type         _last{0};
+  size_type         _lineno{0};
+  size_type         _offset{0};
+};
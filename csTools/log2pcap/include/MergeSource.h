@@ -0,0 +1,137 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <cs/Logging/Logger.h>
+
+#include "FrameStore.h"
+#include "LineInfo.h"
+#include "LineReader.h"
+#include "ParseErrors.h"
+#include "Parser.h"
+
+/*
+ * NOTE: MergeSource merges the frames of several candump logs into a single,
+ *       time-ordered sequence using a k-way merge over a min-heap.
+ *
+ * NOTE: Each input is read in batches of at most batchSize frames; while the
+ *       current batch is consumed, the next one is parsed concurrently. Hence
+ *       at most two batches and one read block are held per input.
+ *
+ * NOTE: Frames with equal timestamps are handed out in the order the inputs
+ *       were added. Each input collects its own ParseErrors, which are
+ *       logged by reportErrors().
+ */
+
+class MergeSource {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_BATCH_SIZE = 4096;
+  static constexpr size_type DEFAULT_BLOCK_SIZE = 64*1024;
+
+  MergeSource(const cs::LoggerPtr& logger,
+              const parser::ParseFunc parse = parser::parseLine,
+              const FrameFilter *filter = nullptr,
+              const size_type batchSize = DEFAULT_BATCH_SIZE,
+              const size_type blockSize = DEFAULT_BLOCK_SIZE) noexcept;
+  ~MergeSource() noexcept;
+
+  bool add(const std::filesystem::path& path);
+
+  bool getInfo(LineInfo& info);
+
+  // NOTE: Corrupt compressed input; valid once getInfo() returned false.
+  bool isError() const;
+
+  // NOTE: Valid once getInfo() returned false.
+  void reportErrors() const;
+
+private:
+  using Infos  = FrameStore;
+  using Result = std::future<Infos>;
+
+  struct Input {
+    Input(const size_type blockSize) noexcept
+      : reader(blockSize)
+    {
+    }
+
+    Infos                 batch;
+    ParseErrors           errors;
+    Infos::const_iterator iter;
+    Result                next;
+    std::filesystem::path path;
+    LineReader            reader;
+  };
+
+  using InputPtr = std::unique_ptr<Input>;
+
+  struct Entry {
+    int64_t   time{0};
+    size_type index{0};
+
+    inline bool operator>(const Entry& other) const
+    {
+      return time != other.time
+          ? time > other.time
+          : index > other.index;
+    }
+  };
+
+  MergeSource(const MergeSource&) noexcept = delete;
+  MergeSource& operator=(const MergeSource&) noexcept = delete;
+
+  void dispatch(Input& input);
+  bool load(const size_type index);
+  void push(const size_type index);
+  void start();
+  static Infos readBatch(Input *input, const size_type batchSize,
+                         const parser::ParseFunc parse, const FrameFilter *filter);
+
+  size_type             _batchSize{DEFAULT_BATCH_SIZE};
+  size_type             _blockSize{DEFAULT_BLOCK_SIZE};
+  const FrameFilter    *_filter{nullptr};
+  std::vector<Entry>    _heap;
+  std::vector<InputPtr> _inputs;
+  cs::LoggerPtr         _logger;
+  parser::ParseFunc     _parse{nullptr};
+  bool                  _started{false};
+};
@@ -60,6 +60,9 @@ static_assert( sizeof(pcap_hdr) == 24 );
 // NOTE: Magic Number denotes seconds/microseconds timestamps!
 inline constexpr uint32_t MAGIC_NUMBER = 0xA1B2C3D4;
 
+// NOTE: Magic Number denotes seconds/nanoseconds timestamps!
+inline constexpr uint32_t MAGIC_NUMBER_NSEC = 0xA1B23C4D;
+
 inline constexpr uint16_t VERSION_MAJOR = 2;
 inline constexpr uint16_t VERSION_MINOR = 4;
 
@@ -79,3 +82,71 @@ struct pcaprec_hdr {
 #pragma pack(pop)
 
 static_assert( sizeof(pcaprec_hdr) == 16 );
+
+////// PCAPNG ////////////////////////////////////////////////////////////////
+
+/*
+ * References:
+ * https://datatracker.ietf.org/doc/html/draft-ietf-opsawg-pcapng
+ *
+ * NOTE: Every block is padded to a multiple of 32bits and followed by a
+ *       copy of its 'block_total_length'.
+ */
+
+inline constexpr uint32_t PCAPNG_BLOCK_SHB = 0x0A0D0D0A;
+inline constexpr uint32_t PCAPNG_BLOCK_IDB = 0x00000001;
+inline constexpr uint32_t PCAPNG_BLOCK_EPB = 0x00000006;
+
+inline constexpr uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+
+inline constexpr uint16_t PCAPNG_VERSION_MAJOR = 1;
+inline constexpr uint16_t PCAPNG_VERSION_MINOR = 0;
+
+inline constexpr uint16_t PCAPNG_OPT_ENDOFOPT   = 0;
+inline constexpr uint16_t PCAPNG_OPT_IF_NAME    = 2;
+inline constexpr uint16_t PCAPNG_OPT_IF_TSRESOL = 9;
+
+// NOTE: 'if_tsresol' denotes 10^-value seconds per timestamp unit.
+inline constexpr uint8_t PCAPNG_TSRESOL_USEC = 6;
+inline constexpr uint8_t PCAPNG_TSRESOL_NSEC = 9;
+
+#pragma pack(push,1)
+
+struct pcapng_block_hdr {
+  uint32_t block_type;         /* block type */
+  uint32_t block_total_length; /* total length of block, in octets */
+};
+
+struct pcapng_shb {
+  uint32_t byte_order_magic;   /* byte-order magic */
+  uint16_t version_major;      /* major version number */
+  uint16_t version_minor;      /* minor version number */
+  int64_t  section_length;     /* length of section, -1 if unspecified */
+};
+
+struct pcapng_idb {
+  uint16_t linktype;           /* data link type */
+  uint16_t reserved;           /* reserved, must be zero */
+  uint32_t snaplen;            /* max length of captured packets, in octets */
+};
+
+struct pcapng_epb {
+  uint32_t interface_id;       /* index of interface description block */
+  uint32_t timestamp_high;     /* upper 32bits of timestamp */
+  uint32_t timestamp_low;      /* lower 32bits of timestamp */
+  uint32_t captured_len;       /* number of octets of packet saved in file */
+  uint32_t orig_len;           /* actual length of packet */
+};
+
+struct pcapng_opt_hdr {
+  uint16_t option_code;        /* option code */
+  uint16_t option_length;      /* length of option value, in octets */
+};
+
+#pragma pack(pop)
+
+static_assert( sizeof(pcapng_block_hdr) ==  8 );
+static_assert( sizeof(pcapng_shb)       == 16 );
+static_assert( sizeof(pcapng_idb)       ==  8 );
+static_assert( sizeof(pcapng_epb)       == 20 );
+static_assert( sizeof(pcapng_opt_hdr)   ==  4 );
@@ -0,0 +1,97 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <cs/Logging/Logger.h>
+
+#include "ChunkedParser.h"
+#include "FrameFilter.h"
+#include "ParseErrors.h"
+#include "Parser.h"
+#include "Rotation.h"
+
+/*
+ * NOTE: ParallelPcapWriter converts an in-memory text into a pcap file.
+ *       Each newline-aligned chunk is parsed and serialized by a worker,
+ *       which then writes its records directly to their final position in
+ *       the file. As every record is either RECORD_SIZE_CAN or
+ *       RECORD_SIZE_CANFD bytes long, a chunk's offset is the prefix sum of
+ *       its predecessors' sizes; a worker only waits for this sum to become
+ *       available, never for its predecessor's write to complete.
+ *
+ * NOTE: At most 2*numThreads chunks are in flight; an empty 'device'
+ *       accepts the frames of all devices.
+ *
+ * NOTE: With rotation, a worker walks its records' sizes and timestamps to
+ *       decide where new pieces start; it opens these pieces before handing
+ *       on its position. Hence, the pieces are written concurrently, too.
+ */
+
+class ParallelPcapWriter {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type DEFAULT_CHUNK_SIZE = ChunkedParser::DEFAULT_CHUNK_SIZE;
+
+  ParallelPcapWriter(const cs::LoggerPtr& logger, ParseErrors& errors,
+                     const size_type numThreads = 0,
+                     const parser::ParseFunc parse = parser::parseLine,
+                     const FrameFilter *filter = nullptr,
+                     const size_type chunkSize = DEFAULT_CHUNK_SIZE) noexcept;
+  ~ParallelPcapWriter() noexcept;
+
+  size_type numFrames() const;
+
+  void setRotation(const Rotation& rotation);
+
+  bool write(const std::filesystem::path& output, const std::string_view& text,
+             const std::string& device = std::string());
+
+private:
+  ParallelPcapWriter(const ParallelPcapWriter&) noexcept = delete;
+  ParallelPcapWriter& operator=(const ParallelPcapWriter&) noexcept = delete;
+
+  size_type          _chunkSize{DEFAULT_CHUNK_SIZE};
+  ParseErrors&       _errors;
+  const FrameFilter *_filter{nullptr};
+  cs::LoggerPtr      _logger;
+  size_type          _maxPending{0};
+  size_type          _numFrames{0};
+  parser::ParseFunc  _parse{nullptr};
+  Rotation           _rotation;
+};
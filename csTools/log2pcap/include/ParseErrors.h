@@ -0,0 +1,125 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include <cs/Logging/Logger.h>
+
+/*
+ * NOTE: ParseErrors collects the messages of the line parsers instead of
+ *       logging each one: adding a message merely counts its category and
+ *       keeps the line number and offending text of the first 'maxSamples'
+ *       lines per category. report() logs all categories at once.
+ *
+ * NOTE: Adding is lock-free, thus chunks may be parsed concurrently. Then,
+ *       the samples are those added first, not necessarily those with the
+ *       lowest line numbers!
+ */
+
+class ParseErrors {
+public:
+  using size_type = std::size_t;
+
+  enum class Category : std::size_t {
+    EmptyLine = 0,
+    InvalidStart,
+    MissingTime,
+    IncompleteTime,
+    InvalidTime,
+    MissingDevice,
+    InvalidDeviceSeparator,
+    MissingId,
+    InvalidIdSeparator,
+    InvalidId,
+    InvalidType,
+    MissingExtra,
+    InvalidExtra,
+    DataExceeded,
+    IncompleteData,
+    MissingRawDlc,
+    InvalidRawDlc,
+    Num
+  };
+
+  static constexpr size_type DEFAULT_MAX_SAMPLES = 5;
+  static constexpr size_type MAX_SAMPLE_SIZE     = 32;
+  static constexpr size_type NUM_CATEGORIES      = static_cast<size_type>(Category::Num);
+
+  ParseErrors(const size_type maxSamples = DEFAULT_MAX_SAMPLES) noexcept;
+  ~ParseErrors() noexcept;
+
+  inline void add(const Category category, const size_type lineno,
+                  const std::string_view& text = std::string_view())
+  {
+    const size_type i = static_cast<size_type>(category);
+    const size_type index = _counts[i].fetch_add(1, std::memory_order_relaxed);
+    if( index < _maxSamples ) {
+      addSample(i, index, lineno, text);
+    }
+  }
+
+  inline void add(const Category category, const size_type lineno, const char ch)
+  {
+    add(category, lineno, std::string_view(&ch, 1));
+  }
+
+  void clear();
+  size_type count(const Category category) const;
+
+  // NOTE: Not to be called while adding concurrently.
+  void report(const cs::LoggerPtr& logger, const std::filesystem::path& input) const;
+
+private:
+  struct Sample {
+    size_type                        lineno{0};
+    uint8_t                          size{0};
+    std::array<char,MAX_SAMPLE_SIZE> text{};
+  };
+
+  ParseErrors(const ParseErrors&) noexcept = delete;
+  ParseErrors& operator=(const ParseErrors&) noexcept = delete;
+
+  void addSample(const size_type category, const size_type index,
+                 const size_type lineno, const std::string_view& text);
+
+  std::array<std::atomic<size_type>,NUM_CATEGORIES> _counts;
+  size_type                                         _maxSamples{DEFAULT_MAX_SAMPLES};
+  std::vector<Sample>                               _samples;
+};
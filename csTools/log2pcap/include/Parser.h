@@ -0,0 +1,121 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <expected>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "FrameFilter.h"
+#include "LineInfo.h"
+#include "ParseErrors.h"
+
+namespace parser {
+
+  using ConstViewIter = std::string_view::const_iterator;
+
+  using ParseFunc = LineInfo (*)(const std::string_view& line,
+                                 ParseErrors& errors, const std::size_t lineno,
+                                 const FrameFilter *filter);
+
+  bool parseData(LineInfo& result, ConstViewIter& first, const ConstViewIter& last,
+                 ParseErrors& errors, const std::size_t lineno);
+
+  bool parseDevice(DeviceId& result, ConstViewIter& first, const ConstViewIter& last,
+                   ParseErrors& errors, const std::size_t lineno);
+
+  bool parseId(LineInfo& result, ConstViewIter& first, const ConstViewIter& last,
+               ParseErrors& errors, const std::size_t lineno);
+
+  bool parseRawDLC(uint8_t& result, ConstViewIter& first, const ConstViewIter& last,
+                   ParseErrors& errors, const std::size_t lineno);
+
+  std::expected<cs::TimeVal,std::errc> parseTime(const std::string_view& str);
+
+  bool parseTime(cs::TimeVal& result, ConstViewIter& first, const ConstViewIter& last,
+                 ParseErrors& errors, const std::size_t lineno);
+
+  bool parseType(LineInfo& result, ConstViewIter& first, const ConstViewIter& last,
+                 ParseErrors& errors, const std::size_t lineno);
+
+  LineInfo parseLine(ConstViewIter first, const ConstViewIter& last,
+                     ParseErrors& errors, const std::size_t lineno,
+                     const FrameFilter *filter = nullptr);
+
+  LineInfo parseLine(const std::string_view& line,
+                     ParseErrors& errors, const std::size_t lineno,
+                     const FrameFilter *filter = nullptr);
+
+  // NOTE: Sequentially parse the lines of ReaderT (e.g. LineReader, LineSplitter);
+  //       lines rejected by the optional 'filter' are skipped.
+
+  template<typename ReaderT>
+  class LineParser {
+  public:
+    LineParser(ReaderT& reader, ParseErrors& errors,
+               const ParseFunc parse = parseLine,
+               const FrameFilter *filter = nullptr) noexcept
+      : _errors{errors}
+      , _filter{filter}
+      , _parse{parse}
+      , _reader{reader}
+    {
+    }
+
+    ~LineParser() noexcept = default;
+
+    bool getInfo(LineInfo& info)
+    {
+      std::string_view line;
+      while( _reader.getLine(line) ) {
+        info = _parse(line, _errors, _reader.lineNo(), _filter);
+        if( info.isValid() ) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+  private:
+    LineParser() noexcept = delete;
+
+    ParseErrors&       _errors;
+    const FrameFilter *_filter{nullptr};
+    ParseFunc          _parse{nullptr};
+    ReaderT&           _reader;
+  };
+
+} // namespace parser
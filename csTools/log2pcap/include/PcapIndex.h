@@ -0,0 +1,144 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <cs/System/Time.h>
+
+#include "LineInfo.h"
+
+/*
+ * NOTE: PcapIndex is a sidecar of a pcap file written by PcapWriter. Records
+ *       are grouped into blocks of 'interval' consecutive records; for each
+ *       block its byte range and the range of its timestamps are kept.
+ *       Additionally, the number of frames per CAN ID is counted.
+ *
+ * NOTE: The timestamps of a log need not be monotonic; hence ranges() yields
+ *       all blocks whose timestamps intersect the requested window.
+ *
+ * NOTE: The size of the pcap file and its number of records are kept to
+ *       detect a sidecar that is stale, i.e. that belongs to an earlier
+ *       version of the pcap file.
+ *
+ * Sidecar Layout (little endian):
+ *
+ * pcapidx_hdr
+ * pcapidx_block[num_blocks]
+ * pcapidx_count[num_ids]
+ */
+
+#pragma pack(push,1)
+
+struct pcapidx_hdr {
+  uint32_t magic_number;   /* magic number */
+  uint16_t version_major;  /* major version number */
+  uint16_t version_minor;  /* minor version number */
+  uint32_t interval;       /* records per block */
+  uint32_t reserved;       /* reserved, must be zero */
+  uint64_t num_blocks;     /* number of blocks */
+  uint64_t num_ids;        /* number of per-ID counts */
+  uint64_t pcap_size;      /* size of the pcap file */
+  uint64_t num_records;    /* number of records of the pcap file */
+};
+
+struct pcapidx_block {
+  uint64_t offset_begin;   /* file offset of first record */
+  uint64_t offset_end;     /* file offset past last record */
+  uint64_t count;          /* number of records */
+  int64_t  time_min;       /* earliest timestamp [us] */
+  int64_t  time_max;       /* latest timestamp [us] */
+};
+
+struct pcapidx_count {
+  uint32_t can_id;         /* CAN ID including CAN_EFF_FLAG */
+  uint32_t reserved;       /* reserved, must be zero */
+  uint64_t count;          /* number of frames */
+};
+
+#pragma pack(pop)
+
+static_assert( sizeof(pcapidx_hdr)   == 48 );
+static_assert( sizeof(pcapidx_block) == 40 );
+static_assert( sizeof(pcapidx_count) == 16 );
+
+inline constexpr uint32_t PCAPIDX_MAGIC_NUMBER = 0x58444950; // "PIDX"
+
+inline constexpr uint16_t PCAPIDX_VERSION_MAJOR = 2;
+inline constexpr uint16_t PCAPIDX_VERSION_MINOR = 0;
+
+class PcapIndex {
+public:
+  using size_type = std::size_t;
+  using Blocks    = std::vector<pcapidx_block>;
+  using Counts    = std::unordered_map<canid_t,uint64_t>;
+
+  static constexpr size_type DEFAULT_INTERVAL = 1024;
+
+  static constexpr int64_t MIN_TIME = std::numeric_limits<int64_t>::min();
+  static constexpr int64_t MAX_TIME = std::numeric_limits<int64_t>::max();
+
+  PcapIndex(const size_type interval = DEFAULT_INTERVAL) noexcept;
+  ~PcapIndex() noexcept;
+
+  void add(const uint64_t offset, const LineInfo& info);
+  void clear();
+
+  const Blocks& blocks() const;
+  const Counts& counts() const;
+  size_type interval() const;
+  uint64_t numRecords() const;
+  uint64_t pcapSize() const;
+
+  Blocks ranges(const cs::TimeVal& from, const cs::TimeVal& to) const;
+
+  bool load(const std::filesystem::path& path);
+  bool save(const std::filesystem::path& path) const;
+
+  static int64_t lowerBound(const cs::TimeVal& from);
+  static int64_t upperBound(const cs::TimeVal& to);
+
+  static std::filesystem::path sidecarPath(const std::filesystem::path& pcap);
+
+private:
+  Blocks    _blocks;
+  Counts    _counts;
+  size_type _interval{DEFAULT_INTERVAL};
+  uint64_t  _numRecords{0};
+  uint64_t  _pcapSize{0};
+};
@@ -0,0 +1,77 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <filesystem>
+#include <map>
+#include <string>
+
+#include "BufferedFile.h"
+#include "IFrameSink.h"
+
+/*
+ * NOTE: PcapNgSink writes the frames of all devices to a single pcapng file;
+ *       an Interface Description Block is emitted for each device as it is
+ *       first seen, and each Enhanced Packet Block references it.
+ */
+
+class PcapNgSink : public IFrameSink {
+public:
+  ~PcapNgSink();
+
+  bool close();
+  bool flush();
+  std::size_t numFrames() const;
+  bool write(const LineInfo& info);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const bool nanoseconds = false);
+
+private:
+  using Interfaces = std::map<DeviceId,uint32_t>;
+
+  PcapNgSink() = delete;
+  PcapNgSink(const bool nanoseconds);
+
+  bool interfaceId(uint32_t& id, const DeviceId device);
+  bool writeInterface(const std::string& name);
+  bool writeSection();
+
+  BufferedFile _file;
+  Interfaces   _interfaces;
+  DeviceId     _lastDevice{INVALID_DEVICE};
+  uint32_t     _lastId{0};
+  bool         _nanoseconds{false};
+  std::size_t  _numFrames{0};
+};
@@ -0,0 +1,88 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+
+#include <cs/Core/ByteArray.h>
+#include <cs/System/Time.h>
+
+#include "MappedFile.h"
+#include "PcapIndex.h"
+
+/*
+ * NOTE: PcapRecord refers to the mapped pcap file of a PcapRangeReader;
+ *       'frame' is the serialized can_frame or canfd_frame.
+ */
+
+struct PcapRecord {
+  const cs::byte_t *frame{nullptr};
+  uint64_t          offset{0};
+  std::size_t       size{0};
+  cs::TimeVal       time{-1};
+};
+
+/*
+ * NOTE: PcapRangeReader hands out the records of a pcap file within the
+ *       window [from,to) by only visiting the blocks listed in its sidecar.
+ *       Without a sidecar, the whole file is scanned.
+ */
+
+class PcapRangeReader {
+public:
+  PcapRangeReader() noexcept;
+  ~PcapRangeReader() noexcept;
+
+  void close();
+  bool open(const std::filesystem::path& pcap);
+
+  const PcapIndex& index() const;
+
+  void setRange(const cs::TimeVal& from, const cs::TimeVal& to);
+
+  bool getRecord(PcapRecord& record);
+
+private:
+  PcapRangeReader(const PcapRangeReader&) noexcept = delete;
+  PcapRangeReader& operator=(const PcapRangeReader&) noexcept = delete;
+
+  PcapIndex         _index;
+  PcapIndex::Blocks _blocks;
+  std::size_t       _idxBlock{0};
+  cs::TimeVal       _from{-1};
+  MappedFile        _pcap;
+  uint64_t          _pos{0};
+  cs::TimeVal       _to{-1};
+};
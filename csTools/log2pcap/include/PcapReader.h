@@ -0,0 +1,94 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <cs/Core/ByteArray.h>
+#include <cs/Logging/Logger.h>
+
+#include "LineInfo.h"
+#include "MappedFile.h"
+
+/*
+ * NOTE: PcapReader maps a pcap or pcapng file into memory and decodes its
+ *       SocketCAN records into LineInfos; it is the inverse of PcapSink and
+ *       PcapNgSink. Records of any other link type are skipped.
+ *
+ * NOTE: Plain pcap files do not name a device; their frames are assigned to
+ *       'device'. In pcapng files, each interface provides its 'if_name';
+ *       unnamed interfaces are assigned to 'device', too.
+ *
+ * NOTE: Only files written in the host's byte order are supported.
+ */
+
+class PcapReader {
+public:
+  PcapReader(const cs::LoggerPtr& logger) noexcept;
+  ~PcapReader() noexcept;
+
+  void close();
+  bool isOpen() const;
+  bool open(const std::filesystem::path& path, const std::string& device);
+
+  bool getInfo(LineInfo& info);
+
+  static bool decodeFrame(LineInfo& info, const cs::byte_t *frame, const std::size_t size);
+
+private:
+  struct Interface {
+    DeviceId device{INVALID_DEVICE};
+    bool     is_can{false};
+    uint8_t  tsresol{0};
+  };
+
+  PcapReader() noexcept = delete;
+  PcapReader(const PcapReader&) noexcept = delete;
+  PcapReader& operator=(const PcapReader&) noexcept = delete;
+
+  bool getPcap(LineInfo& info);
+  bool getPcapNg(LineInfo& info);
+  bool readInterface(const std::size_t offset, const std::size_t length);
+
+  DeviceId               _device{INVALID_DEVICE};
+  MappedFile             _file;
+  std::vector<Interface> _interfaces;
+  bool                   _is_nsec{false};
+  bool                   _is_pcapng{false};
+  cs::LoggerPtr          _logger;
+  std::size_t            _pos{0};
+};
@@ -0,0 +1,71 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "IFrameSink.h"
+#include "PcapIndex.h"
+#include "Writer.h"
+
+/*
+ * NOTE: PcapSink writes all frames of 'device' to a single pcap file;
+ *       an empty 'device' accepts the frames of all devices. Optionally,
+ *       a PcapIndex sidecar is written alongside the pcap file on close().
+ */
+
+class PcapSink : public IFrameSink {
+public:
+  ~PcapSink();
+
+  bool close();
+  bool flush();
+  std::size_t numFrames() const;
+  bool write(const LineInfo& info);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const std::string& device = std::string(),
+                              const bool index = false);
+
+private:
+  PcapSink() = delete;
+  PcapSink(const std::filesystem::path& output, const std::string& device,
+           const bool index);
+
+  DeviceId                   _device{INVALID_DEVICE};
+  std::unique_ptr<PcapIndex> _index;
+  std::size_t                _numFrames{0};
+  std::filesystem::path      _output;
+  writer::PcapWriter         _writer;
+};
@@ -0,0 +1,198 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "FrameStore.h"
+#include "LineInfo.h"
+
+/*
+ * NOTE: ReorderSource restores the time order of a source's frames (e.g.
+ *       LineParser, ChunkedParser) whose timestamps are slightly out of
+ *       order, as happens when several interfaces are logged into a single
+ *       file. Frames are held until they are older than the newest frame
+ *       seen by at least 'horizon'; hence, memory is bounded by the number
+ *       of frames within the horizon, not by the size of the input.
+ *
+ * NOTE: Held frames are packed into FrameStores of STORE_FRAMES frames each;
+ *       the min-heap merely orders their timestamps, sequence numbers and
+ *       views (cf. MergeSource). A store is recycled once all of its frames
+ *       have been handed out.
+ *
+ * NOTE: A frame arriving later than 'horizon' is still handed out as early
+ *       as possible, but out of order; such frames are counted by numLate().
+ *       Frames with equal timestamps keep their original order.
+ *
+ * NOTE: Once the source is exhausted, the held frames are drained. Sources
+ *       that may grow (i.e. follow mode) disable draining until their end.
+ */
+
+template<typename SourceT>
+class ReorderSource {
+public:
+  using size_type = std::size_t;
+
+  static constexpr size_type STORE_FRAMES = 4096;
+
+  ReorderSource(SourceT& source, const std::chrono::microseconds& horizon,
+                const bool drain = true) noexcept
+    : _drain{drain}
+    , _horizon{horizon.count()}
+    , _source{source}
+  {
+  }
+
+  ~ReorderSource() noexcept = default;
+
+  bool getInfo(LineInfo& info)
+  {
+    while( !isReady()  &&  _source.getInfo(info) ) {
+      push(info);
+    }
+
+    if( _heap.empty()  ||  (!isReady()  &&  !_drain) ) {
+      return false;
+    }
+
+    std::pop_heap(_heap.begin(), _heap.end(), std::greater<Entry>{});
+    const Entry entry = _heap.back();
+    _heap.pop_back();
+
+    entry.frame.get(info);
+    release(entry.seq);
+
+    _last = entry.time;
+
+    return true;
+  }
+
+  size_type numLate() const
+  {
+    return _numLate;
+  }
+
+  size_type size() const
+  {
+    return _heap.size();
+  }
+
+  void setDrain(const bool on)
+  {
+    _drain = on;
+  }
+
+private:
+  struct Entry {
+    int64_t   time{0};
+    uint64_t  seq{0};
+    FrameView frame;
+
+    inline bool operator>(const Entry& other) const
+    {
+      return time != other.time
+          ? time > other.time
+          : seq > other.seq;
+    }
+  };
+
+  // NOTE: Store 'i' holds the frames of sequence numbers [i,i+1)*STORE_FRAMES.
+  struct Store {
+    FrameStore frames;
+    size_type  numHeld{0};
+  };
+
+  ReorderSource() noexcept = delete;
+  ReorderSource(const ReorderSource&) noexcept = delete;
+  ReorderSource& operator=(const ReorderSource&) noexcept = delete;
+
+  bool isReady() const
+  {
+    return !_heap.empty()  &&  _heap.front().time + _horizon <= _newest;
+  }
+
+  void push(const LineInfo& info)
+  {
+    const int64_t time = info.time.value();
+    if( time < _last ) {
+      _numLate++;
+    }
+    _newest = std::max(_newest, time);
+
+    if( _stores.empty()  ||  _stores.back().frames.size() == STORE_FRAMES ) {
+      if( !_spares.empty() ) {
+        _stores.emplace_back(std::move(_spares.back()));
+        _spares.pop_back();
+      } else {
+        _stores.emplace_back(FrameStore(STORE_FRAMES*FrameStore::recordSize(CAN_MAX_DLEN)));
+      }
+    }
+
+    Store& store = _stores.back();
+    store.numHeld++;
+
+    _heap.push_back({time, _seq++, store.frames.push_back(info)});
+    std::push_heap(_heap.begin(), _heap.end(), std::greater<Entry>{});
+  }
+
+  void release(const uint64_t seq)
+  {
+    _stores[seq/STORE_FRAMES - _firstStore].numHeld--;
+
+    // NOTE: The newest store may still be filled.
+    while( _stores.size() > 1  &&  _stores.front().numHeld == 0 ) {
+      _spares.push_back(std::move(_stores.front().frames));
+      _spares.back().clear();
+      _stores.pop_front();
+      _firstStore++;
+    }
+  }
+
+  bool                    _drain{true};
+  uint64_t                _firstStore{0};
+  std::vector<Entry>      _heap;
+  int64_t                 _horizon{0};
+  int64_t                 _last{-1};
+  int64_t                 _newest{-1};
+  size_type               _numLate{0};
+  uint64_t                _seq{0};
+  SourceT&                _source;
+  std::vector<FrameStore> _spares;
+  std::deque<Store>       _stores;
+};
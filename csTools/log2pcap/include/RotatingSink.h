@@ -0,0 +1,75 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "IFrameSink.h"
+#include "Rotation.h"
+
+/*
+ * NOTE: RotatingSink writes the frames of 'device' to a sequence of pcap
+ *       files according to 'rotation'; an empty 'device' accepts the frames
+ *       of all devices. Each piece is written by its own PcapSink, i.e. with
+ *       an optional PcapIndex sidecar per piece.
+ */
+
+class RotatingSink : public IFrameSink {
+public:
+  ~RotatingSink();
+
+  bool close();
+  bool flush();
+  std::size_t numFrames() const;
+  bool write(const LineInfo& info);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const Rotation& rotation,
+                              const std::string& device = std::string(),
+                              const bool index = false);
+
+private:
+  RotatingSink() = delete;
+  RotatingSink(const std::filesystem::path& output, const Rotation& rotation,
+               const std::string& device, const bool index);
+
+  bool openPiece(const std::size_t index);
+
+  DeviceId              _device{INVALID_DEVICE};
+  bool                  _index{false};
+  std::size_t           _numFrames{0};
+  std::filesystem::path _output;
+  Rotation::Piece       _piece;
+  Rotation              _rotation;
+  IFrameSinkPtr         _sink;
+};
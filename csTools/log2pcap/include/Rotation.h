@@ -0,0 +1,67 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <filesystem>
+
+/*
+ * NOTE: Rotation splits an output into a sequence of pcap files, named
+ *       "<stem>_<nnnnn><ext>" and numbered from zero; each piece starts
+ *       with its own pcap_hdr. A new piece is started before a record that
+ *       would grow the current piece beyond 'maxBytes', or whose timestamp
+ *       is 'maxSpan' or more past the first record of the current piece.
+ *       Zero disables either limit; no piece is ever left empty.
+ */
+
+struct Rotation {
+  using size_type = std::size_t;
+
+  struct Piece {
+    size_type index{0};
+    size_type numRecords{0};
+    size_type size{0};       // including the pcap_hdr
+    int64_t   timeFirst{0};  // [us]
+  };
+
+  bool isDue(const Piece& piece, const size_type recordSize, const int64_t time) const;
+  bool isEnabled() const;
+
+  static std::filesystem::path piecePath(const std::filesystem::path& output,
+                                         const size_type index);
+
+  size_type                 maxBytes{0};
+  std::chrono::microseconds maxSpan{0};
+};
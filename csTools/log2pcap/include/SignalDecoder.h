@@ -0,0 +1,114 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <cs/Logging/Logger.h>
+
+#include <Encode/Engine.h>
+
+#include "LineInfo.h"
+#include "SocketCAN.h"
+
+/*
+ * NOTE: SignalDecoder applies a set of Encode(...) definitions to the payload
+ *       of every frame. The text of a definition names the CAN ID in candump
+ *       notation, i.e. an ID with 8 hexadecimal digits denotes an extended
+ *       frame; an optional suffix ":be" selects big-endian byte order of the
+ *       payload (default: ":le"). The word is made of the first numBits/8
+ *       payload bytes:
+ *
+ *       Encode(16, "1A0") = { 0x2[3:0]@12, speed[11:0]@0 }
+ *
+ *       Literal fields select the definitions applicable to a payload; thus
+ *       several definitions of one ID decode a multiplexed message. Above's
+ *       variable 'speed' yields the signal "1A0.speed".
+ *
+ * NOTE: Values are the raw, unsigned bit patterns of the variables.
+ */
+
+class SignalDecoder {
+public:
+  using  size_type = std::size_t;
+  using value_type = uint64_t;
+
+  struct Value {
+    size_type  signal{0};
+    value_type value{0};
+  };
+
+  using Values = std::vector<Value>;
+
+  SignalDecoder() noexcept;
+  ~SignalDecoder() noexcept;
+
+  bool decode(Values& result, const LineInfo& info) const;
+  bool load(const std::filesystem::path& path, const cs::LoggerPtr& logger);
+  const std::string& name(const size_type signal) const;
+  size_type numSignals() const;
+  bool parse(const std::string_view& text, const cs::LoggerPtr& logger);
+
+private:
+  using Engine    = Encode::Engine<value_type>;
+  using EnginePtr = Encode::EnginePtr<value_type>;
+  using Field     = Encode::IField<value_type>;
+
+  // NOTE: A part contributes the bits of 'field' to the message's 'slot'.
+  struct Part {
+    const Field *field{nullptr};
+    size_type    slot{0};
+  };
+
+  struct Message {
+    EnginePtr              engine;
+    bool                   is_be{false};
+    size_type              numBytes{0};
+    std::vector<Part>      parts;
+    std::vector<size_type> signals;
+  };
+
+  using Messages = std::unordered_map<canid_t,std::vector<Message>>;
+
+  SignalDecoder(const SignalDecoder&) noexcept = delete;
+  SignalDecoder& operator=(const SignalDecoder&) noexcept = delete;
+
+  Messages                 _messages;
+  std::vector<std::string> _names;
+};
@@ -0,0 +1,125 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BufferedFile.h"
+#include "IFrameSink.h"
+#include "SignalDecoder.h"
+
+/*
+ * NOTE: Binary Layout of the Signal Columns (host byte order)
+ *
+ * sigcol_hdr
+ * For Each Series, i.e. per device and signal:
+ *   uint16_t length; char name[length];   -> "<device>.<signal>"
+ *   uint64_t count;
+ *   int64_t  time[count];                 -> [us]
+ *   uint64_t value[count];
+ */
+
+inline constexpr uint32_t SIGCOL_MAGIC_NUMBER  = 0x43474953; // "SIGC"
+inline constexpr uint16_t SIGCOL_VERSION_MAJOR = 1;
+inline constexpr uint16_t SIGCOL_VERSION_MINOR = 0;
+
+struct sigcol_hdr {
+  uint32_t magic_number;
+  uint16_t version_major;
+  uint16_t version_minor;
+  uint64_t num_series;
+};
+
+static_assert( sizeof(sigcol_hdr) == 16 );
+
+/*
+ * NOTE: SignalSink decodes every frame written to it with 'decoder' and
+ *       writes the signals' time series to 'output':
+ *
+ *       Csv:    One row "time,device,signal,value" per decoded value in the
+ *               order of the frames; 'time' is formatted as secs.usecs.
+ *       Binary: One pair of columns per series; all series are held in
+ *               memory and written on close().
+ *
+ * NOTE: 'decoder' is shared and must outlive the sink.
+ */
+
+class SignalSink : public IFrameSink {
+public:
+  using size_type = std::size_t;
+
+  enum class Format {
+    Csv,
+    Binary
+  };
+
+  ~SignalSink();
+
+  bool close();
+  bool flush();
+  size_type numFrames() const;
+  bool write(const LineInfo& info);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const SignalDecoder *decoder, const Format format);
+
+private:
+  using value_type = SignalDecoder::value_type;
+
+  struct Series {
+    DeviceId                device{INVALID_DEVICE};
+    size_type               signal{0};
+    std::vector<int64_t>    time;
+    std::vector<value_type> value;
+  };
+
+  SignalSink() = delete;
+  SignalSink(const SignalDecoder *decoder, const Format format);
+
+  Series& series(const DeviceId device, const size_type signal);
+  bool writeSeries();
+
+  const SignalDecoder                   *_decoder{nullptr};
+  BufferedFile                           _file;
+  Format                                 _format{Format::Csv};
+  size_type                              _numFrames{0};
+  std::string                            _row;
+  std::vector<Series>                    _series;
+  std::unordered_map<uint64_t,size_type> _seriesIndex;
+  SignalDecoder::Values                  _values;
+};
@@ -93,3 +93,12 @@ struct canfd_frame {
 #pragma pack(pop)
 
 static_assert( sizeof(canfd_frame) == CANFD_MTU );
+
+////// CAN Filter ////////////////////////////////////////////////////////////
+
+inline constexpr canid_t CAN_INV_FILTER = 0x20000000;
+
+struct can_filter {
+  canid_t can_id;
+  canid_t can_mask;
+};
@@ -0,0 +1,68 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "BusStatistics.h"
+#include "IFrameSink.h"
+
+/*
+ * NOTE: StatisticsSink collects the BusStatistics of all frames written to
+ *       it; the report is written to 'output' on close().
+ */
+
+class StatisticsSink : public IFrameSink {
+public:
+  ~StatisticsSink();
+
+  bool close();
+  bool flush();
+  std::size_t numFrames() const;
+  bool write(const LineInfo& info);
+
+  const BusStatistics& statistics() const;
+
+  static std::string report(const BusStatistics& stats);
+
+  static IFrameSinkPtr create(const std::filesystem::path& output,
+                              const BusTiming& timing = BusTiming());
+
+private:
+  StatisticsSink() = delete;
+  StatisticsSink(const std::filesystem::path& output, const BusTiming& timing);
+
+  std::size_t           _numFrames{0};
+  std::filesystem::path _output;
+  BusStatistics         _stats;
+};
@@ -0,0 +1,92 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <filesystem>
+
+#include "BufferedFile.h"
+#include "LineInfo.h"
+#include "PCAP.h"
+
+namespace writer {
+
+  inline constexpr std::size_t RECORD_SIZE_CAN   = sizeof(pcaprec_hdr) + CAN_MTU;
+  inline constexpr std::size_t RECORD_SIZE_CANFD = sizeof(pcaprec_hdr) + CANFD_MTU;
+  inline constexpr std::size_t MAX_RECORD_SIZE   = RECORD_SIZE_CANFD;
+
+  pcap_hdr makeHeader();
+
+  std::size_t recordSize(const LineInfo& info);
+
+  std::size_t serialize(void *dest, const LineInfo& info);
+
+  std::size_t serializeCAN(void *dest, const LineInfo& info);
+
+  std::size_t serializeFD(void *dest, const LineInfo& info);
+
+  std::size_t serializeFrame(void *dest, const LineInfo& info);
+
+  std::size_t serializeFrameCAN(void *dest, const LineInfo& info);
+
+  std::size_t serializeFrameFD(void *dest, const LineInfo& info);
+
+  /*
+   * NOTE: PcapWriter serializes the records into the staging buffer of a
+   *       BufferedFile; position() is the file offset of the next record.
+   */
+
+  class PcapWriter {
+  public:
+    using size_type = std::size_t;
+
+    static constexpr size_type DEFAULT_BUFFER_SIZE = BufferedFile::DEFAULT_BUFFER_SIZE;
+
+    PcapWriter(const size_type bufferSize = DEFAULT_BUFFER_SIZE) noexcept;
+    ~PcapWriter() noexcept;
+
+    bool close();
+    bool flush();
+    bool isOpen() const;
+    bool open(const std::filesystem::path& path);
+    size_type position() const;
+    bool write(const LineInfo& info);
+
+  private:
+    PcapWriter(const PcapWriter&) noexcept = delete;
+    PcapWriter& operator=(const PcapWriter&) noexcept = delete;
+
+    BufferedFile _file;
+  };
+
+} // namespace writer
@@ -0,0 +1,423 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
+#include "ArchiveReader.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_archive {
+
+  constexpr int64_t MIN_TIME = std::numeric_limits<int64_t>::min();
+  constexpr int64_t MAX_TIME = std::numeric_limits<int64_t>::max();
+
+  // NOTE: Larger ranges of extended IDs are not enumerated into the bitmap.
+  constexpr canid_t MAX_RANGE_IDS = 0x10000;
+
+  inline int64_t lowerBound(const cs::TimeVal& from)
+  {
+    return from.isValid()
+        ? from.value()
+        : MIN_TIME;
+  }
+
+  inline int64_t upperBound(const cs::TimeVal& to)
+  {
+    return to.isValid()
+        ? to.value()
+        : MAX_TIME;
+  }
+
+  inline bool intersects(const uint64_t *a, const uint64_t *b)
+  {
+    for(std::size_t i = 0; i < CANARC_BITMAP_WORDS; i++) {
+      if( (a[i] & b[i]) != 0 ) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template<typename ColumnT>
+  inline bool readByte(uint8_t& result, ColumnT& column)
+  {
+    if( column.first == column.last ) {
+      return false;
+    }
+    result = *column.first++;
+    return true;
+  }
+
+  template<typename ColumnT>
+  bool readVarint(uint64_t& result, ColumnT& column)
+  {
+    result = 0;
+    for(unsigned int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = 0;
+      if( !readByte(byte, column) ) {
+        return false;
+      }
+
+      result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if( (byte & 0x80) == 0 ) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /*
+   * NOTE: The query bitmap of extended IDs is exact for plain IDs and small
+   *       ranges only; any other filter might accept every extended ID.
+   */
+
+  void makeEffQuery(uint64_t *query, const FrameFilter& filter)
+  {
+    constexpr canid_t EFF_ID_MASK = CAN_EFF_FLAG | CAN_EFF_MASK;
+
+    for(const can_filter& f : filter.filters()) {
+      const bool is_inv = (f.can_id & CAN_INV_FILTER) != 0;
+
+      // NOTE: Filter accepts standard IDs only.
+      if( !is_inv  &&  (f.can_mask & CAN_EFF_FLAG) != 0  &&  (f.can_id & CAN_EFF_FLAG) == 0 ) {
+        continue;
+      }
+
+      if( !is_inv  &&  (f.can_mask & EFF_ID_MASK) == EFF_ID_MASK ) {
+        canarcSetBit(query, canarcEffBit(f.can_id));
+        continue;
+      }
+
+      std::fill_n(query, CANARC_BITMAP_WORDS, std::numeric_limits<uint64_t>::max());
+      return;
+    }
+
+    for(const FrameFilter::Range& range : filter.ranges()) {
+      if( range.second - range.first >= MAX_RANGE_IDS ) {
+        std::fill_n(query, CANARC_BITMAP_WORDS, std::numeric_limits<uint64_t>::max());
+        return;
+      }
+
+      for(canid_t id = range.first; id <= range.second; id++) {
+        canarcSetBit(query, canarcEffBit(id));
+      }
+    }
+  }
+
+  void makeSffQuery(uint64_t *query, const FrameFilter& filter)
+  {
+    for(canid_t id = 0; id <= CAN_SFF_MASK; id++) {
+      if( filter.acceptId(id)  ||  filter.acceptId(id | CAN_RTR_FLAG) ) {
+        canarcSetBit(query, canarcSffBit(id));
+      }
+    }
+  }
+
+} // namespace impl_archive
+
+////// public ////////////////////////////////////////////////////////////////
+
+ArchiveReader::ArchiveReader() noexcept
+{
+}
+
+ArchiveReader::~ArchiveReader() noexcept
+{
+}
+
+void ArchiveReader::close()
+{
+  _blocks.clear();
+  _devices.clear();
+  _file.close();
+  _is_error = false;
+
+  setFilter(nullptr);
+}
+
+bool ArchiveReader::isError() const
+{
+  return _is_error;
+}
+
+bool ArchiveReader::isOpen() const
+{
+  return _file.isOpen();
+}
+
+bool ArchiveReader::open(const std::filesystem::path& path)
+{
+  close();
+
+  if( !_file.open(path)  ||  _file.size() < sizeof(canarc_hdr) + sizeof(canarc_trailer) ) {
+    close();
+    return false;
+  }
+
+  canarc_hdr header;
+  memcpy(&header, _file.data(), sizeof(canarc_hdr));
+
+  canarc_trailer trailer;
+  memcpy(&trailer, _file.data() + _file.size() - sizeof(canarc_trailer), sizeof(canarc_trailer));
+
+  if( header.magic_number != CANARC_MAGIC_NUMBER  ||
+      header.version_major != CANARC_VERSION_MAJOR  ||
+      trailer.magic_number != CANARC_MAGIC_NUMBER ) {
+    close();
+    return false;
+  }
+
+  // (1) Directory ///////////////////////////////////////////////////////////
+
+  const uint64_t sizeBlocks = trailer.num_blocks*sizeof(canarc_block);
+  if( trailer.offset_devices < sizeof(canarc_hdr)  ||
+      trailer.offset_devices > trailer.offset_blocks  ||
+      trailer.num_blocks > _file.size()/sizeof(canarc_block)  ||
+      trailer.offset_blocks + sizeBlocks + sizeof(canarc_trailer) != _file.size() ) {
+    close();
+    return false;
+  }
+
+  _blocks.resize(trailer.num_blocks);
+  memcpy(_blocks.data(), _file.data() + trailer.offset_blocks, sizeBlocks);
+
+  for(const canarc_block& block : _blocks) {
+    const uint64_t size = uint64_t{block.size_time} + block.size_id + block.size_flags +
+        block.size_device + block.size_data;
+    if( block.offset < sizeof(canarc_hdr)  ||  block.offset + size > trailer.offset_devices ) {
+      close();
+      return false;
+    }
+  }
+
+  // (2) Device Table ////////////////////////////////////////////////////////
+
+  const char *data = _file.data() + trailer.offset_devices;
+  const char *last = _file.data() + trailer.offset_blocks;
+  for(uint64_t i = 0; i < trailer.num_devices; i++) {
+    uint16_t length = 0;
+    if( last - data < static_cast<std::ptrdiff_t>(sizeof(uint16_t)) ) {
+      close();
+      return false;
+    }
+    memcpy(&length, data, sizeof(uint16_t));
+    data += sizeof(uint16_t);
+
+    if( last - data < length ) {
+      close();
+      return false;
+    }
+    _devices.push_back(devices::intern(std::string_view(data, length)));
+    data += length;
+  }
+
+  setFilter(nullptr);
+
+  return true;
+}
+
+ArchiveReader::size_type ArchiveReader::numBlocks() const
+{
+  return _blocks.size();
+}
+
+ArchiveReader::size_type ArchiveReader::numBlocksRead() const
+{
+  return _numBlocksRead;
+}
+
+ArchiveReader::size_type ArchiveReader::numFrames() const
+{
+  size_type result = 0;
+  for(const canarc_block& block : _blocks) {
+    result += block.count;
+  }
+
+  return result;
+}
+
+void ArchiveReader::setFilter(const FrameFilter *filter)
+{
+  using namespace impl_archive;
+
+  _filter = filter;
+
+  _is_anyId = _filter == nullptr  ||
+      (_filter->filters().empty()  &&  _filter->ranges().empty());
+
+  std::fill_n(_effQuery, CANARC_BITMAP_WORDS, 0);
+  std::fill_n(_sffQuery, CANARC_BITMAP_WORDS, 0);
+  if( !_is_anyId ) {
+    makeEffQuery(_effQuery, *_filter);
+    makeSffQuery(_sffQuery, *_filter);
+  }
+
+  _idxBlock = 0;
+  _numBlocksRead = 0;
+  _numLeft = 0;
+}
+
+bool ArchiveReader::getInfo(LineInfo& info)
+{
+  while( !_is_error ) {
+    if( _numLeft == 0  &&  !nextBlock() ) {
+      return false;
+    }
+
+    const cs::byte_t *data = nullptr;
+    if( !decodeFrame(info, data) ) {
+      _is_error = true;
+      return false;
+    }
+
+    if( _filter != nullptr  &&  !_filter->accept(info) ) {
+      continue;
+    }
+
+    // NOTE: Copy the payload of accepted frames only.
+    const uint8_t len = info.is_rtr
+        ? 0
+        : info.len;
+    memcpy(info.data.data(), data, len);
+    memset(info.data.data() + len, 0, info.data.size() - len);
+
+    return true;
+  }
+
+  return false;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool ArchiveReader::acceptBlock(const canarc_block& block) const
+{
+  using namespace impl_archive;
+
+  if( _filter != nullptr ) {
+    if( block.time_max <  lowerBound(_filter->from())  ||
+        block.time_min >= upperBound(_filter->to()) ) {
+      return false;
+    }
+  }
+
+  return _is_anyId  ||
+      intersects(block.sff_bitmap, _sffQuery)  ||
+      intersects(block.eff_bitmap, _effQuery);
+}
+
+bool ArchiveReader::decodeFrame(LineInfo& info, const cs::byte_t*& data)
+{
+  using namespace impl_archive;
+
+  uint64_t delta = 0;
+  uint64_t id = 0;
+  uint8_t flags = 0;
+  uint8_t len = 0;
+  uint64_t device = 0;
+  if( !readVarint(delta, _time)  ||  !readVarint(id, _id)  ||
+      !readByte(flags, _flags)  ||  !readByte(len, _flags)  ||
+      !readVarint(device, _device) ) {
+    return false;
+  }
+
+  uint8_t len8_dlc = 0;
+  if( (flags & CANARC_FLAG_LEN8) != 0  &&  !readByte(len8_dlc, _flags) ) {
+    return false;
+  }
+
+  if( id > std::numeric_limits<canid_t>::max()  ||  len > CANFD_MAX_DLEN  ||
+      device >= _devices.size() ) {
+    return false;
+  }
+
+  const bool is_rtr = (flags & CANARC_FLAG_RTR) != 0;
+  const std::size_t sizeData = is_rtr
+      ? 0
+      : len;
+  if( static_cast<std::size_t>(_data.last - _data.first) < sizeData ) {
+    return false;
+  }
+
+  data = _data.first;
+  _data.first += sizeData;
+
+  _lastTime += canarcUnZigZag(delta);
+
+  info.device   = _devices[device];
+  info.fdflags  = flags >> CANARC_FDFLAGS_SHIFT;
+  info.id       = static_cast<canid_t>(id);
+  info.is_canfd = (flags & CANARC_FLAG_CANFD) != 0;
+  info.is_ext   = (flags & CANARC_FLAG_EXT) != 0;
+  info.is_rtr   = is_rtr;
+  info.len      = len;
+  info.len8_dlc = len8_dlc;
+  info.time     = cs::TimeVal{_lastTime};
+
+  _numLeft--;
+
+  return true;
+}
+
+bool ArchiveReader::nextBlock()
+{
+  while( _idxBlock < _blocks.size() ) {
+    const canarc_block& block = _blocks[_idxBlock++];
+    if( block.count == 0  ||  !acceptBlock(block) ) {
+      continue;
+    }
+
+    const cs::byte_t *first = reinterpret_cast<const cs::byte_t*>(_file.data()) + block.offset;
+
+    _time   = {first, first + block.size_time};
+    first  += block.size_time;
+    _id     = {first, first + block.size_id};
+    first  += block.size_id;
+    _flags  = {first, first + block.size_flags};
+    first  += block.size_flags;
+    _device = {first, first + block.size_device};
+    first  += block.size_device;
+    _data   = {first, first + block.size_data};
+
+    _lastTime = block.time_first;
+    _numBlocksRead++;
+    _numLeft = block.count;
+
+    return true;
+  }
+
+  return false;
+}
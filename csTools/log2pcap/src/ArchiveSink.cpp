@@ -0,0 +1,257 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "ArchiveSink.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_archive {
+
+  void appendVarint(std::vector<cs::byte_t>& column, uint64_t value)
+  {
+    while( value >= 0x80 ) {
+      column.push_back(static_cast<cs::byte_t>(value | 0x80));
+      value >>= 7;
+    }
+    column.push_back(static_cast<cs::byte_t>(value));
+  }
+
+  inline bool writeColumn(BufferedFile& file, const std::vector<cs::byte_t>& column)
+  {
+    return column.empty()  ||  file.write(column.data(), column.size());
+  }
+
+} // namespace impl_archive
+
+////// public ////////////////////////////////////////////////////////////////
+
+ArchiveSink::~ArchiveSink()
+{
+}
+
+bool ArchiveSink::close()
+{
+  if( !_file.isOpen() ) {
+    return true;
+  }
+
+  bool ok = writeBlock();
+
+  canarc_trailer trailer;
+  trailer.offset_devices = _file.position();
+  trailer.num_devices    = _devices.size();
+
+  for(const DeviceId device : _devices) {
+    const std::string& name = devices::name(device);
+
+    const uint16_t length = static_cast<uint16_t>(std::min<std::size_t>(name.size(),
+                                                                        std::numeric_limits<uint16_t>::max()));
+    ok = _file.write(&length, sizeof(uint16_t))  &&  ok;
+    ok = _file.write(name.data(), length)  &&  ok;
+  }
+
+  trailer.offset_blocks = _file.position();
+  trailer.num_blocks    = _blocks.size();
+  trailer.magic_number  = CANARC_MAGIC_NUMBER;
+  trailer.reserved      = 0;
+
+  if( !_blocks.empty() ) {
+    ok = _file.write(_blocks.data(), _blocks.size()*sizeof(canarc_block))  &&  ok;
+  }
+  ok = _file.write(&trailer, sizeof(canarc_trailer))  &&  ok;
+
+  ok = _file.close()  &&  ok;
+
+  _blocks.clear();
+  _deviceIndex.clear();
+  _devices.clear();
+
+  return ok;
+}
+
+bool ArchiveSink::flush()
+{
+  // NOTE: A flush completes the current block, however small it may be.
+  return writeBlock()  &&  _file.flush();
+}
+
+ArchiveSink::size_type ArchiveSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool ArchiveSink::write(const LineInfo& info)
+{
+  using namespace impl_archive;
+
+  const int64_t time = info.time.value();
+  const uint8_t  len = std::min<uint8_t>(info.len, CANFD_MAX_DLEN);
+
+  if( _block.count == 0 ) {
+    _block.time_first = time;
+    _block.time_min   = time;
+    _block.time_max   = time;
+    _lastTime = time;
+  }
+
+  appendVarint(_time, canarcZigZag(time - _lastTime));
+  _lastTime = time;
+
+  appendVarint(_id, info.id);
+
+  uint8_t flags = static_cast<uint8_t>((info.fdflags & 0x0F) << CANARC_FDFLAGS_SHIFT);
+  if( info.is_canfd ) {
+    flags |= CANARC_FLAG_CANFD;
+  }
+  if( info.is_ext ) {
+    flags |= CANARC_FLAG_EXT;
+  }
+  if( info.is_rtr ) {
+    flags |= CANARC_FLAG_RTR;
+  }
+  if( info.len8_dlc != 0 ) {
+    flags |= CANARC_FLAG_LEN8;
+  }
+
+  _flags.push_back(flags);
+  _flags.push_back(len);
+  if( info.len8_dlc != 0 ) {
+    _flags.push_back(info.len8_dlc);
+  }
+
+  appendVarint(_device, deviceIndex(info.device));
+
+  // NOTE: Remote frames carry a length, but no data!
+  if( !info.is_rtr ) {
+    _data.insert(_data.end(), info.data.data(), info.data.data() + len);
+  }
+
+  if( info.is_ext ) {
+    canarcSetBit(_block.eff_bitmap, canarcEffBit(info.id));
+  } else {
+    canarcSetBit(_block.sff_bitmap, canarcSffBit(info.id));
+  }
+
+  _numFrames++;
+
+  _block.count++;
+  _block.time_min = std::min(_block.time_min, time);
+  _block.time_max = std::max(_block.time_max, time);
+
+  if( _block.count >= _blockFrames ) {
+    return writeBlock();
+  }
+
+  return true;
+}
+
+IFrameSinkPtr ArchiveSink::create(const std::filesystem::path& output,
+                                  const size_type blockFrames)
+{
+  ArchiveSink *sink = new ArchiveSink(blockFrames);
+  if( !sink->_file.open(output) ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  canarc_hdr header;
+  header.magic_number  = CANARC_MAGIC_NUMBER;
+  header.version_major = CANARC_VERSION_MAJOR;
+  header.version_minor = CANARC_VERSION_MINOR;
+  header.block_frames  = static_cast<uint32_t>(sink->_blockFrames);
+  header.reserved      = 0;
+
+  if( !sink->_file.write(&header, sizeof(canarc_hdr)) ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  return IFrameSinkPtr(sink);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+ArchiveSink::ArchiveSink(const size_type blockFrames)
+  : _blockFrames{std::clamp<size_type>(blockFrames, 1, std::numeric_limits<uint32_t>::max())}
+{
+}
+
+uint32_t ArchiveSink::deviceIndex(const DeviceId device)
+{
+  const auto iter = _deviceIndex.find(device);
+  if( iter != _deviceIndex.end() ) {
+    return iter->second;
+  }
+
+  const uint32_t index = static_cast<uint32_t>(_devices.size());
+  _deviceIndex.emplace(device, index);
+  _devices.push_back(device);
+
+  return index;
+}
+
+bool ArchiveSink::writeBlock()
+{
+  using namespace impl_archive;
+
+  if( _block.count == 0 ) {
+    return true;
+  }
+
+  _block.offset      = _file.position();
+  _block.size_time   = static_cast<uint32_t>(_time.size());
+  _block.size_id     = static_cast<uint32_t>(_id.size());
+  _block.size_flags  = static_cast<uint32_t>(_flags.size());
+  _block.size_device = static_cast<uint32_t>(_device.size());
+  _block.size_data   = static_cast<uint32_t>(_data.size());
+
+  const bool ok =
+      writeColumn(_file, _time)    &&
+      writeColumn(_file, _id)      &&
+      writeColumn(_file, _flags)   &&
+      writeColumn(_file, _device)  &&
+      writeColumn(_file, _data);
+
+  _blocks.push_back(_block);
+
+  _block = canarc_block{};
+  _data.clear();
+  _device.clear();
+  _flags.clear();
+  _id.clear();
+  _time.clear();
+
+  return ok;
+}
@@ -0,0 +1,151 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include "BufferedFile.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+BufferedFile::BufferedFile(const size_type bufferSize) noexcept
+{
+  try {
+    _buffer.resize(bufferSize);
+  } catch(...) {
+    _buffer.clear();
+  }
+}
+
+BufferedFile::~BufferedFile() noexcept
+{
+  close();
+}
+
+bool BufferedFile::close()
+{
+  const bool ok = !isOpen()  ||  flush();
+
+  _file.close();
+  _is_error = false;
+  _position = 0;
+  _used = 0;
+
+  return ok;
+}
+
+bool BufferedFile::flush()
+{
+  if( _is_error  ||  !isOpen() ) {
+    return false;
+  }
+
+  if( _used > 0  &&  _file.write(_buffer.data(), _used) != _used ) {
+    _is_error = true;
+  }
+  _used = 0;
+
+  return !_is_error;
+}
+
+bool BufferedFile::isOpen() const
+{
+  return _file.isOpen();
+}
+
+bool BufferedFile::open(const std::filesystem::path& path)
+{
+  close();
+
+  if( _buffer.empty() ) {
+    return false;
+  }
+
+  const cs::File::OpenFlags flags = cs::FileOpenFlag::Write | cs::FileOpenFlag::Truncate;
+
+  return _file.open(path, flags);
+}
+
+BufferedFile::size_type BufferedFile::position() const
+{
+  return _position;
+}
+
+cs::byte_t *BufferedFile::reserve(const size_type size)
+{
+  if( _is_error  ||  !isOpen()  ||  size > _buffer.size() ) {
+    return nullptr;
+  }
+
+  if( _buffer.size() - _used < size  &&  !flush() ) {
+    return nullptr;
+  }
+
+  return _buffer.data() + _used;
+}
+
+void BufferedFile::commit(const size_type size)
+{
+  _used     += size;
+  _position += size;
+}
+
+bool BufferedFile::write(const void *data, const size_type size)
+{
+  if( _is_error  ||  !isOpen() ) {
+    return false;
+  }
+
+  // NOTE: Blocks exceeding the buffer are written directly.
+  if( size > _buffer.size() ) {
+    if( !flush() ) {
+      return false;
+    }
+
+    if( _file.write(data, size) != size ) {
+      _is_error = true;
+      return false;
+    }
+
+    _position += size;
+
+    return true;
+  }
+
+  cs::byte_t *dest = reserve(size);
+  if( dest == nullptr ) {
+    return false;
+  }
+
+  memcpy(dest, data, size);
+  commit(size);
+
+  return true;
+}
@@ -0,0 +1,360 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <bit>
+
+#include "BusStatistics.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_stats {
+
+  constexpr int64_t USECS_PER_SEC = 1000000;
+
+  constexpr canid_t EMPTY_KEY = 0; // NOTE: Hashed keys carry CAN_EFF_FLAG!
+
+  inline std::size_t hash(const canid_t id)
+  {
+    // NOTE: Fibonacci hashing; the table's capacity is a power of two.
+    return static_cast<std::size_t>((uint64_t{id}*0x9E3779B97F4A7C15) >> 32);
+  }
+
+  inline int64_t floorDiv(const int64_t a, const int64_t b)
+  {
+    const int64_t q = a/b;
+    return (a%b != 0  &&  (a < 0) != (b < 0))
+        ? q - 1
+        : q;
+  }
+
+} // namespace impl_stats
+
+////// public ////////////////////////////////////////////////////////////////
+
+double BusStatistics::IdStats::meanGap() const
+{
+  return numGaps > 0
+      ? static_cast<double>(sumGap)/static_cast<double>(numGaps)
+      : 0.0;
+}
+
+BusStatistics::IdTable::IdTable() noexcept
+{
+}
+
+BusStatistics::IdTable::~IdTable() noexcept
+{
+}
+
+BusStatistics::IdStats& BusStatistics::IdTable::get(const canid_t id)
+{
+  if( (id & CAN_EFF_FLAG) != 0 ) {
+    return getHashed(id);
+  }
+
+  if( !_direct ) {
+    _direct = std::make_unique<IdStats[]>(CAN_SFF_MASK + 1);
+    for(canid_t i = 0; i <= CAN_SFF_MASK; i++) {
+      _direct[i].id = i;
+    }
+  }
+
+  return _direct[id & CAN_SFF_MASK];
+}
+
+std::vector<const BusStatistics::IdStats*> BusStatistics::IdTable::sorted() const
+{
+  std::vector<const IdStats*> result;
+
+  if( _direct ) {
+    for(canid_t i = 0; i <= CAN_SFF_MASK; i++) {
+      if( _direct[i].count > 0 ) {
+        result.push_back(&_direct[i]);
+      }
+    }
+  }
+
+  const size_type numDirect = result.size();
+  for(const IdStats& stats : _hashed) {
+    if( stats.id != impl_stats::EMPTY_KEY ) {
+      result.push_back(&stats);
+    }
+  }
+
+  std::sort(result.begin() + numDirect, result.end(),
+            [](const IdStats *a, const IdStats *b) -> bool {
+    return a->id < b->id;
+  });
+
+  return result;
+}
+
+BusStatistics::BusStatistics(const BusTiming& timing) noexcept
+  : _timing(timing)
+{
+}
+
+BusStatistics::~BusStatistics() noexcept
+{
+}
+
+void BusStatistics::add(const LineInfo& info)
+{
+  using namespace impl_stats;
+
+  const int64_t time = info.time.value();
+
+  // (1) Device //////////////////////////////////////////////////////////////
+
+  DeviceStats& dev = device(info.device);
+
+  dev.count++;
+  if( info.is_canfd ) {
+    dev.countFD++;
+  }
+  if( info.is_ext ) {
+    dev.countExt++;
+  }
+  if( info.is_rtr ) {
+    dev.countRtr++;
+  }
+
+  if( dev.first == NO_TIME  ||  time < dev.first ) {
+    dev.first = time;
+  }
+  if( dev.last != NO_TIME  &&  time < dev.last ) {
+    dev.countReordered++;
+  }
+  dev.last = std::max(dev.last, time);
+
+  // (2) Bus Load ////////////////////////////////////////////////////////////
+
+  const int64_t second = floorDiv(time, USECS_PER_SEC);
+  if( dev.lastBusy == nullptr  ||  second != dev.lastSecond ) {
+    dev.lastBusy   = &dev.busy[second];
+    dev.lastSecond = second;
+  }
+  *dev.lastBusy += duration(info, _timing);
+
+  // (3) ID //////////////////////////////////////////////////////////////////
+
+  IdStats& ids = dev.ids.get(info.is_ext
+                             ? info.id | CAN_EFF_FLAG
+                             : info.id);
+
+  ids.count++;
+  ids.dlc[dlc(info)]++;
+
+  if( ids.last != NO_TIME  &&  time >= ids.last ) {
+    const int64_t gap = time - ids.last;
+
+    ids.numGaps++;
+    ids.minGap  = std::min(ids.minGap, gap);
+    ids.maxGap  = std::max(ids.maxGap, gap);
+    ids.sumGap += gap;
+
+    if( ids.prevGap >= 0 ) {
+      const uint64_t jitter = static_cast<uint64_t>(gap >= ids.prevGap
+                                                    ? gap - ids.prevGap
+                                                    : ids.prevGap - gap);
+      const size_type bin = std::min<size_type>(std::bit_width(jitter), NUM_JITTER_BINS - 1);
+      ids.jitter[bin]++;
+    }
+
+    ids.prevGap = gap;
+  }
+
+  // NOTE: Out-of-order frames do not contribute to the inter-arrival times.
+  ids.last = std::max(ids.last, time);
+}
+
+const BusStatistics::Devices& BusStatistics::devices() const
+{
+  return _devices;
+}
+
+const BusTiming& BusStatistics::timing() const
+{
+  return _timing;
+}
+
+uint8_t BusStatistics::dlc(const LineInfo& info)
+{
+  constexpr uint8_t MAX_DLC = 15;
+
+  if( info.isLen8Dlc() ) {
+    return info.len8_dlc;
+  }
+
+  if( info.len <= CAN_MAX_DLEN ) {
+    return info.len;
+  }
+
+  if( !info.is_canfd ) {
+    return CAN_MAX_DLEN;
+  }
+
+  // NOTE: Smallest DLC covering 'len' bytes.
+  constexpr std::array<uint8_t,7> FD_LEN = {12, 16, 20, 24, 32, 48, 64};
+  for(std::size_t i = 0; i < FD_LEN.size(); i++) {
+    if( info.len <= FD_LEN[i] ) {
+      return static_cast<uint8_t>(CAN_MAX_DLEN + 1 + i);
+    }
+  }
+
+  return MAX_DLC;
+}
+
+double BusStatistics::duration(const LineInfo& info, const BusTiming& timing)
+{
+  const double bitrate     = std::max<uint32_t>(timing.bitrate, 1);
+  const double dataBitrate = std::max<uint32_t>(timing.dataBitrate, 1);
+
+  const uint32_t numData = info.is_rtr
+      ? 0
+      : 8*static_cast<uint32_t>(info.len);
+
+  if( !info.is_canfd ) {
+    // NOTE: SOF..EOF plus intermission; cf. ISO 11898-1.
+    const uint32_t numBits = (info.is_ext ? 67 : 47) + numData;
+    return numBits/bitrate;
+  }
+
+  // NOTE: Arbitration phase (SOF..BRS) and ACK..intermission at nominal rate.
+  const uint32_t numNominal = (info.is_ext ? 36 : 17) + 13;
+
+  // NOTE: ESI, DLC, data, stuff count and CRC at data rate if BRS is set.
+  const uint32_t numCrc  = info.len <= 16 ? 17 : 21;
+  const uint32_t numFast = 1 + 4 + numData + 4 + numCrc;
+
+  const double rate = (info.fdflags & CANFD_BRS) != 0
+      ? dataBitrate
+      : bitrate;
+
+  return numNominal/bitrate + numFast/rate;
+}
+
+double BusStatistics::DeviceStats::busyTime() const
+{
+  double result = 0;
+  for(const std::map<int64_t,double>::value_type& entry : busy) {
+    result += entry.second;
+  }
+
+  return result;
+}
+
+double BusStatistics::DeviceStats::meanLoad() const
+{
+  using namespace impl_stats;
+
+  if( busy.empty() ) {
+    return 0;
+  }
+
+  const int64_t numSecs = floorDiv(last, USECS_PER_SEC) - floorDiv(first, USECS_PER_SEC) + 1;
+
+  return busyTime()/static_cast<double>(numSecs);
+}
+
+double BusStatistics::DeviceStats::maxLoad() const
+{
+  double result = 0;
+  for(const std::map<int64_t,double>::value_type& entry : busy) {
+    result = std::max(result, entry.second);
+  }
+
+  return result;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+BusStatistics::IdStats& BusStatistics::IdTable::getHashed(const canid_t id)
+{
+  using namespace impl_stats;
+
+  // NOTE: Keep the load factor below 1/2.
+  if( 2*(_numHashed + 1) > _hashed.size() ) {
+    rehash(std::max<size_type>(MIN_HASHED, 2*_hashed.size()));
+  }
+
+  const size_type mask = _hashed.size() - 1;
+  for(size_type i = hash(id) & mask; ; i = (i + 1) & mask) {
+    IdStats& stats = _hashed[i];
+    if( stats.id == id ) {
+      return stats;
+    }
+
+    if( stats.id == EMPTY_KEY ) {
+      stats.id = id;
+      _numHashed++;
+      return stats;
+    }
+  }
+}
+
+void BusStatistics::IdTable::rehash(const size_type capacity)
+{
+  using namespace impl_stats;
+
+  std::vector<IdStats> old(capacity);
+  old.swap(_hashed);
+
+  const size_type mask = _hashed.size() - 1;
+  for(IdStats& stats : old) {
+    if( stats.id == EMPTY_KEY ) {
+      continue;
+    }
+
+    size_type i = hash(stats.id) & mask;
+    while( _hashed[i].id != EMPTY_KEY ) {
+      i = (i + 1) & mask;
+    }
+
+    _hashed[i] = stats;
+  }
+}
+
+BusStatistics::DeviceStats& BusStatistics::device(const DeviceId id)
+{
+  // NOTE: Consecutive frames usually stem from the same device!
+  if( _lastDevice != nullptr  &&  _lastDevice->device == id ) {
+    return *_lastDevice;
+  }
+
+  DeviceStats& result = _devices[id];
+  result.device = id;
+
+  _lastDevice = &result;
+
+  return result;
+}
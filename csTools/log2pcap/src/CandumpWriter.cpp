@@ -0,0 +1,209 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+
+#include "CandumpWriter.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_candump {
+
+  constexpr char DIGITS[] = "0123456789ABCDEF";
+
+  // NOTE: Two hexadecimal digits per byte value.
+  constexpr std::array<char,512> HEX_TABLE = []() -> std::array<char,512> {
+    std::array<char,512> table{};
+    for(std::size_t i = 0; i < 256; i++) {
+      table[2*i    ] = DIGITS[i >> 4];
+      table[2*i + 1] = DIGITS[i & 0xF];
+    }
+    return table;
+  }();
+
+  inline char *appendByte(char *dest, const uint8_t value)
+  {
+    const char *hex = HEX_TABLE.data() + 2*value;
+    dest[0] = hex[0];
+    dest[1] = hex[1];
+    return dest + 2;
+  }
+
+  inline char *appendChar(char *dest, const char c)
+  {
+    *dest = c;
+    return dest + 1;
+  }
+
+  // NOTE: Format 'value' with exactly 'numDigits' hexadecimal digits.
+  inline char *appendHex(char *dest, uint32_t value, const std::size_t numDigits)
+  {
+    for(std::size_t i = numDigits; i > 0; i--) {
+      dest[i - 1] = DIGITS[value & 0xF];
+      value >>= 4;
+    }
+    return dest + numDigits;
+  }
+
+  // NOTE: Format 'value' without leading zeros, i.e. like "{:X}".
+  inline char *appendHex(char *dest, const uint32_t value)
+  {
+    std::size_t numDigits = 1;
+    while( numDigits < 8  &&  (value >> 4*numDigits) != 0 ) {
+      numDigits++;
+    }
+    return appendHex(dest, value, numDigits);
+  }
+
+  inline char *appendText(char *dest, const std::string_view& text)
+  {
+    std::copy(text.begin(), text.end(), dest);
+    return dest + text.size();
+  }
+
+  inline char *appendTime(char *dest, const cs::TimeVal& time)
+  {
+    constexpr std::size_t NUM_DIGITS_SECS = 20;
+    constexpr std::size_t NUM_DIGITS_USECS = 6;
+
+    dest = std::to_chars(dest, dest + NUM_DIGITS_SECS, time.secs().count()).ptr;
+    dest = appendChar(dest, '.');
+
+    auto usecs = time.usecs().count();
+    for(std::size_t i = NUM_DIGITS_USECS; i > 0; i--) {
+      dest[i - 1] = char('0' + usecs % 10);
+      usecs /= 10;
+    }
+
+    return dest + NUM_DIGITS_USECS;
+  }
+
+} // namespace impl_candump
+
+////// Public ////////////////////////////////////////////////////////////////
+
+namespace candump {
+
+  std::size_t format(char *dest, const LineInfo& info, const std::string_view& device)
+  {
+    using namespace impl_candump;
+
+    char *cur = dest;
+
+    cur = appendChar(cur, '(');
+    cur = appendTime(cur, info.time);
+    cur = appendText(cur, ") ");
+
+    cur = appendText(cur, device);
+    cur = appendChar(cur, ' ');
+
+    if( info.is_ext ) {
+      cur = appendHex(cur, info.id, 8);
+    } else {
+      cur = appendHex(cur, info.id);
+    }
+    cur = appendChar(cur, '#');
+
+    if( info.is_canfd ) {
+      cur = appendChar(cur, '#');
+      cur = appendHex(cur, info.fdflags);
+    }
+
+    if( info.is_rtr ) {
+      cur = appendChar(cur, 'R');
+      cur = appendHex(cur, info.len);
+    } else {
+      for(uint8_t i = 0; i < info.len; i++) {
+        cur = appendByte(cur, info.data[i]);
+      }
+    }
+
+    if( info.isLen8Dlc() ) {
+      cur = appendChar(cur, '_');
+      cur = appendHex(cur, info.len8_dlc);
+    }
+
+    cur = appendChar(cur, '\n');
+
+    return static_cast<std::size_t>(cur - dest);
+  }
+
+} // namespace candump
+
+////// public ////////////////////////////////////////////////////////////////
+
+CandumpWriter::CandumpWriter(std::FILE *stream, const size_type bufferSize) noexcept
+  : _stream{stream}
+{
+  _buffer.resize(std::max<size_type>(bufferSize, candump::MAX_LINE_SIZE));
+}
+
+CandumpWriter::~CandumpWriter() noexcept
+{
+  flush();
+}
+
+bool CandumpWriter::flush()
+{
+  if( _size < 1 ) {
+    return true;
+  }
+
+  const size_type size = _size;
+  _size = 0;
+
+  return std::fwrite(_buffer.data(), 1, size, _stream) == size  &&  std::fflush(_stream) == 0;
+}
+
+bool CandumpWriter::write(const LineInfo& info)
+{
+  if( _name == nullptr  ||  info.device != _device ) {
+    _device = info.device;
+    _name   = &devices::name(info.device);
+  }
+
+  const size_type maxSize = candump::MAX_LINE_SIZE + _name->size();
+  if( _size + maxSize > _buffer.size() ) {
+    if( !flush() ) {
+      return false;
+    }
+
+    if( maxSize > _buffer.size() ) {
+      _buffer.resize(maxSize);
+    }
+  }
+
+  _size += candump::format(_buffer.data() + _size, info, *_name);
+
+  return true;
+}
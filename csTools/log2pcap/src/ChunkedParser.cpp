@@ -0,0 +1,170 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include "ChunkedParser.h"
+#include "LineSplitter.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+ChunkedParser::ChunkedParser(const std::string_view& text, ParseErrors& errors,
+                             const size_type numThreads,
+                             const parser::ParseFunc parse,
+                             const FrameFilter *filter,
+                             const size_type chunkSize) noexcept
+  : _chunkSize{std::max<size_type>(chunkSize, 1)}
+  , _errors{errors}
+  , _filter{filter}
+  , _parse{parse}
+  , _text(text)
+{
+  constexpr size_type TWO = 2;
+
+  _maxPending = TWO*(numThreads > 0
+                     ? numThreads
+                     : defaultThreads());
+}
+
+ChunkedParser::~ChunkedParser() noexcept
+{
+  // NOTE: Wait for all outstanding chunks; they reference '_text'!
+  for(Result& result : _pending) {
+    if( result.valid() ) {
+      result.wait();
+    }
+  }
+}
+
+bool ChunkedParser::getInfo(LineInfo& info)
+{
+  while( _iter == _infos.end() ) {
+    while( _pending.size() < _maxPending  &&  dispatch() ) {
+    }
+
+    if( _pending.empty() ) {
+      return false;
+    }
+
+    _infos = _pending.front().get();
+    _iter = _infos.begin();
+    _pending.pop_front();
+  }
+
+  (*_iter++).get(info);
+
+  return true;
+}
+
+ChunkedParser::size_type ChunkedParser::defaultThreads()
+{
+  return std::max<size_type>(std::thread::hardware_concurrency(), 1);
+}
+
+std::string_view ChunkedParser::nextChunk(const std::string_view& text, size_type& pos,
+                                          const size_type chunkSize)
+{
+  constexpr size_type NPOS = std::string_view::npos;
+  constexpr size_type  ONE = 1;
+
+  if( pos >= text.size() ) {
+    return std::string_view();
+  }
+
+  // NOTE: Align chunk to the next line ending.
+  size_type end = std::min(pos + std::max<size_type>(chunkSize, ONE), text.size());
+  if( end < text.size() ) {
+    const size_type eol = text.find('\n', end - ONE);
+    end = eol != NPOS
+        ? eol + ONE
+        : text.size();
+  }
+
+  const std::string_view chunk = text.substr(pos, end - pos);
+  pos = end;
+
+  return chunk;
+}
+
+FrameStore ChunkedParser::parseChunk(const std::string_view& chunk,
+                                     const size_type lineno,
+                                     ParseErrors& errors,
+                                     const parser::ParseFunc parse,
+                                     const FrameFilter *filter)
+{
+  constexpr size_type TWO = 2;
+
+  // NOTE: A typical line of ~64 characters yields a record of ~32 bytes.
+  FrameStore infos(chunk.size()/TWO);
+
+  LineSplitter splitter(chunk, lineno);
+
+  std::string_view line;
+  while( splitter.getLine(line) ) {
+    LineInfo info = parse(line, errors, splitter.lineNo(), filter);
+    if( !info.isValid() ) {
+      continue;
+    }
+
+    infos.push_back(info);
+  }
+
+  return infos;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool ChunkedParser::dispatch()
+{
+  if( _pos >= _text.size() ) {
+    return false;
+  }
+
+  // (1) Next newline-aligned chunk //////////////////////////////////////////
+
+  const std::string_view chunk = nextChunk(_text, _pos, _chunkSize);
+  const size_type lineno = _lineno;
+
+  _lineno += std::count(chunk.begin(), chunk.end(), '\n');
+
+  // (2) Parse chunk concurrently ////////////////////////////////////////////
+
+  try {
+    _pending.push_back(std::async(std::launch::async, parseChunk, chunk, lineno, std::ref(_errors), _parse, _filter));
+  } catch(...) {
+    _pending.push_back(std::async(std::launch::deferred, parseChunk, chunk, lineno, std::ref(_errors), _parse, _filter));
+  }
+
+  return true;
+}
+
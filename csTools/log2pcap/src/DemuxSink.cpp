@@ -0,0 +1,138 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cs/System/PathFormatter.h>
+
+#include "DemuxSink.h"
+
+#include "PcapSink.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+DemuxSink::~DemuxSink()
+{
+}
+
+bool DemuxSink::close()
+{
+  bool ok = true;
+  for(Sinks::value_type& entry : _sinks) {
+    if( entry.second  &&  !entry.second->close() ) {
+      ok = false;
+    }
+  }
+
+  _lastDevice = INVALID_DEVICE;
+  _lastSink = nullptr;
+
+  return ok;
+}
+
+bool DemuxSink::flush()
+{
+  bool ok = true;
+  for(Sinks::value_type& entry : _sinks) {
+    if( entry.second  &&  !entry.second->flush() ) {
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+std::size_t DemuxSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool DemuxSink::write(const LineInfo& info)
+{
+  IFrameSink *dest = sink(info.device);
+  if( dest == nullptr  ||  !dest->write(info) ) {
+    return false;
+  }
+
+  _numFrames++;
+
+  return true;
+}
+
+std::filesystem::path DemuxSink::outputPath(const std::filesystem::path& output,
+                                            const std::string& device)
+{
+  std::filesystem::path result = output;
+  result.replace_filename(output.stem().string() + "_" + device);
+  result.replace_extension(output.extension());
+  return result;
+}
+
+IFrameSinkPtr DemuxSink::create(const std::filesystem::path& output,
+                                const cs::LoggerPtr& logger,
+                                const bool index)
+{
+  return IFrameSinkPtr(new DemuxSink(output, logger, index));
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+DemuxSink::DemuxSink(const std::filesystem::path& output, const cs::LoggerPtr& logger,
+                     const bool index)
+  : _index{index}
+  , _logger{logger}
+  , _output(output)
+{
+}
+
+IFrameSink *DemuxSink::sink(const DeviceId device)
+{
+  // NOTE: Consecutive frames usually stem from the same device!
+  if( _lastSink != nullptr  &&  device == _lastDevice ) {
+    return _lastSink;
+  }
+
+  Sinks::iterator hit = _sinks.find(device);
+  if( hit == _sinks.end() ) {
+    const std::string& name = devices::name(device);
+    const std::filesystem::path path = outputPath(_output, name);
+
+    IFrameSinkPtr sink = PcapSink::create(path, name, _index);
+    if( !sink ) {
+      _logger->logError(u8"Unable to open file \"{}\"!", path);
+    }
+
+    hit = _sinks.emplace(device, std::move(sink)).first;
+  }
+
+  _lastDevice = device;
+  _lastSink   = hit->second.get();
+
+  return _lastSink;
+}
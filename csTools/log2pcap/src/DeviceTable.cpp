@@ -0,0 +1,146 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+
+#include "DeviceTable.h"
+
+namespace devices {
+
+  ////// Private /////////////////////////////////////////////////////////////
+
+  namespace impl_devices {
+
+    using Ids   = std::map<std::string_view,DeviceId>;
+    using Names = std::deque<std::string>; // NOTE: Elements never move!
+
+    struct Table {
+      Ids               ids;
+      std::shared_mutex mutex;
+      Names             names;
+    };
+
+    Table& table()
+    {
+      static Table t;
+      return t;
+    }
+
+    // NOTE: Consecutive lookups usually refer to the same device!
+
+    struct LastHit {
+      DeviceId         id{INVALID_DEVICE};
+      std::string_view name;
+    };
+
+    thread_local LastHit lastHit;
+
+    inline DeviceId remember(const DeviceId id, const std::string_view& name)
+    {
+      lastHit.id   = id;
+      lastHit.name = name;
+      return id;
+    }
+
+  } // namespace impl_devices
+
+  ////// Public //////////////////////////////////////////////////////////////
+
+  std::size_t count()
+  {
+    impl_devices::Table& t = impl_devices::table();
+
+    std::shared_lock lock(t.mutex);
+    return t.names.size();
+  }
+
+  DeviceId find(const std::string_view& name)
+  {
+    using namespace impl_devices;
+
+    if( lastHit.id != INVALID_DEVICE  &&  name == lastHit.name ) {
+      return lastHit.id;
+    }
+
+    Table& t = table();
+
+    std::shared_lock lock(t.mutex);
+
+    const Ids::const_iterator hit = t.ids.find(name);
+    return hit != t.ids.cend()
+        ? remember(hit->second, hit->first)
+        : INVALID_DEVICE;
+  }
+
+  DeviceId intern(const std::string_view& name)
+  {
+    using namespace impl_devices;
+
+    if( name.empty() ) {
+      return INVALID_DEVICE;
+    }
+
+    if( const DeviceId id = find(name); id != INVALID_DEVICE ) {
+      return id;
+    }
+
+    Table& t = table();
+
+    std::unique_lock lock(t.mutex);
+
+    // NOTE: Another thread may have interned 'name' in the meantime!
+    if( const Ids::const_iterator hit = t.ids.find(name); hit != t.ids.cend() ) {
+      return remember(hit->second, hit->first);
+    }
+
+    const DeviceId id = static_cast<DeviceId>(t.names.size());
+    const std::string_view key = t.names.emplace_back(name);
+    t.ids.emplace(key, id);
+
+    return remember(id, key);
+  }
+
+  const std::string& name(const DeviceId id)
+  {
+    static const std::string EMPTY;
+
+    impl_devices::Table& t = impl_devices::table();
+
+    std::shared_lock lock(t.mutex);
+    return id < t.names.size()
+        ? t.names[id]
+        : EMPTY;
+  }
+
+} // namespace devices
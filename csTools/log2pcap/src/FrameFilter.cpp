@@ -0,0 +1,261 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <cs/Text/StringValue.h>
+
+#include "FrameFilter.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_filter {
+
+  constexpr std::size_t MAX_EFF_DIGITS = 8;
+
+  bool toId(canid_t& result, const std::string_view& str)
+  {
+    if( str.empty()  ||  str.size() > MAX_EFF_DIGITS ) {
+      return false;
+    }
+
+    const auto expVal = cs::toValue<canid_t>(str, 16);
+    if( !expVal ) {
+      return false;
+    }
+
+    result = expVal.value();
+
+    return true;
+  }
+
+} // namespace impl_filter
+
+////// public ////////////////////////////////////////////////////////////////
+
+FrameFilter::FrameFilter() noexcept
+{
+}
+
+FrameFilter::~FrameFilter() noexcept
+{
+}
+
+bool FrameFilter::isEmpty() const
+{
+  return
+      _devices.empty()  &&
+      _filters.empty()  &&
+      _ranges.empty()   &&
+      !_from.isValid()  &&
+      !_to.isValid();
+}
+
+void FrameFilter::addDevice(const std::string_view& name)
+{
+  const DeviceId device = devices::intern(name);
+  if( device == INVALID_DEVICE ) {
+    return;
+  }
+
+  if( std::find(_devices.cbegin(), _devices.cend(), device) == _devices.cend() ) {
+    _devices.push_back(device);
+  }
+}
+
+void FrameFilter::addId(const canid_t can_id, const canid_t can_mask)
+{
+  _filters.push_back({can_id, can_mask});
+}
+
+/*
+ * NOTE: Accepted specifications (hexadecimal, cf. candump):
+ *
+ * <can_id>              -> pass if id == can_id (data or remote frame)
+ * <can_id>:<can_mask>   -> pass if (id & mask) == (can_id & mask)
+ * <can_id>~<can_mask>   -> pass if (id & mask) != (can_id & mask)
+ * <first>-<last>        -> pass if first <= id <= last
+ *
+ * An ID with 8 digits denotes an extended frame (CAN_EFF_FLAG).
+ */
+
+bool FrameFilter::addId(const std::string_view& spec)
+{
+  using namespace impl_filter;
+
+  const std::size_t pos = spec.find_first_of(":~-");
+  if( pos == std::string_view::npos ) {
+    canid_t id = 0;
+    if( !toId(id, spec) ) {
+      return false;
+    }
+
+    if(        spec.size() == MAX_EFF_DIGITS  &&  id <= CAN_EFF_MASK ) {
+      addId(id | CAN_EFF_FLAG, CAN_EFF_FLAG | CAN_EFF_MASK);
+    } else if( spec.size() < MAX_EFF_DIGITS  &&  id <= CAN_SFF_MASK ) {
+      addId(id, CAN_EFF_FLAG | CAN_SFF_MASK);
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
+  const std::string_view strLhs = spec.substr(0, pos);
+  const std::string_view strRhs = spec.substr(pos + 1);
+
+  canid_t lhs = 0;
+  canid_t rhs = 0;
+  if( !toId(lhs, strLhs)  ||  !toId(rhs, strRhs) ) {
+    return false;
+  }
+
+  if( spec[pos] == '-' ) {
+    if( lhs > CAN_EFF_MASK  ||  rhs > CAN_EFF_MASK  ||  lhs > rhs ) {
+      return false;
+    }
+
+    addRange(lhs, rhs);
+    return true;
+  }
+
+  if( strLhs.size() == MAX_EFF_DIGITS ) {
+    lhs |= CAN_EFF_FLAG;
+  }
+
+  if( spec[pos] == '~' ) {
+    lhs |= CAN_INV_FILTER;
+  }
+
+  // NOTE: Error frames are never logged by candump as such.
+  addId(lhs, rhs & ~CAN_ERR_FLAG);
+
+  return true;
+}
+
+void FrameFilter::addRange(const canid_t first, const canid_t last)
+{
+  _ranges.emplace_back(first, last);
+}
+
+void FrameFilter::setWindow(const cs::TimeVal& from, const cs::TimeVal& to)
+{
+  _from = from;
+  _to   = to;
+}
+
+bool FrameFilter::acceptDevice(const DeviceId device) const
+{
+  return _devices.empty()  ||
+      std::find(_devices.cbegin(), _devices.cend(), device) != _devices.cend();
+}
+
+bool FrameFilter::acceptId(const canid_t can_id) const
+{
+  if( _filters.empty()  &&  _ranges.empty() ) {
+    return true;
+  }
+
+  for(const can_filter& filter : _filters) {
+    const bool is_match =
+        (can_id & filter.can_mask) == (filter.can_id & filter.can_mask & ~CAN_INV_FILTER);
+    const bool is_inv = (filter.can_id & CAN_INV_FILTER) != 0;
+
+    if( is_match != is_inv ) {
+      return true;
+    }
+  }
+
+  const canid_t id = can_id & CAN_EFF_MASK;
+  for(const Range& range : _ranges) {
+    if( range.first <= id  &&  id <= range.second ) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool FrameFilter::acceptTime(const cs::TimeVal& time) const
+{
+  if( _from.isValid()  &&  time.value() < _from.value() ) {
+    return false;
+  }
+
+  if( _to.isValid()  &&  time.value() >= _to.value() ) {
+    return false;
+  }
+
+  return true;
+}
+
+bool FrameFilter::accept(const LineInfo& info) const
+{
+  return
+      acceptTime(info.time)      &&
+      acceptDevice(info.device)  &&
+      acceptId(canId(info));
+}
+
+const std::vector<can_filter>& FrameFilter::filters() const
+{
+  return _filters;
+}
+
+const cs::TimeVal& FrameFilter::from() const
+{
+  return _from;
+}
+
+const std::vector<FrameFilter::Range>& FrameFilter::ranges() const
+{
+  return _ranges;
+}
+
+const cs::TimeVal& FrameFilter::to() const
+{
+  return _to;
+}
+
+canid_t FrameFilter::canId(const LineInfo& info)
+{
+  canid_t result = info.id;
+
+  if( info.is_ext ) {
+    result |= CAN_EFF_FLAG;
+  }
+
+  if( info.is_rtr ) {
+    result |= CAN_RTR_FLAG;
+  }
+
+  return result;
+}
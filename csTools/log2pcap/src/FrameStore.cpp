@@ -0,0 +1,209 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+#include <memory>
+
+#include "FrameStore.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_store {
+
+  constexpr std::size_t ALIGNMENT = sizeof(uint64_t);
+
+  constexpr std::size_t align(const std::size_t size)
+  {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  }
+
+} // namespace impl_store
+
+////// public ////////////////////////////////////////////////////////////////
+
+void FrameView::get(LineInfo& info) const
+{
+  info.device   = _header->device;
+  info.fdflags  = _header->fdflags;
+  info.id       = _header->id;
+  info.is_canfd = isCanFD();
+  info.is_ext   = isExt();
+  info.is_rtr   = isRtr();
+  info.len      = _header->len;
+  info.len8_dlc = _header->len8_dlc;
+  info.time     = cs::TimeVal{_header->time};
+
+  memcpy(info.data.data(), data(), _header->len);
+  memset(info.data.data() + _header->len, 0, info.data.size() - _header->len);
+}
+
+LineInfo FrameView::toInfo() const
+{
+  LineInfo info;
+  get(info);
+  return info;
+}
+
+FrameStore::const_iterator& FrameStore::const_iterator::operator++()
+{
+  _offset += recordSize(header()->len);
+
+  // NOTE: Skip to the next block; there are no empty blocks in use.
+  if( _offset >= _store->_blocks[_idxBlock].used ) {
+    _idxBlock++;
+    _offset = 0;
+  }
+
+  return *this;
+}
+
+FrameStore::FrameStore(const size_type blockSize) noexcept
+  : _blockSize{std::max(impl_store::align(blockSize), recordSize(CANFD_MAX_DLEN))}
+{
+}
+
+FrameStore::~FrameStore() noexcept
+{
+}
+
+FrameStore::const_iterator FrameStore::begin() const
+{
+  return const_iterator(this, 0);
+}
+
+FrameStore::const_iterator FrameStore::end() const
+{
+  return const_iterator(this, _numBlocks);
+}
+
+void FrameStore::clear()
+{
+  // NOTE: Keep the allocated blocks for reuse.
+  for(Block& block : _blocks) {
+    block.used = 0;
+  }
+
+  _numBlocks = 0;
+  _numFrames = 0;
+}
+
+bool FrameStore::empty() const
+{
+  return _numFrames == 0;
+}
+
+FrameStore::size_type FrameStore::size() const
+{
+  return _numFrames;
+}
+
+FrameStore::size_type FrameStore::capacityBytes() const
+{
+  return _blocks.size()*_blockSize;
+}
+
+FrameStore::size_type FrameStore::usedBytes() const
+{
+  size_type result = 0;
+  for(size_type i = 0; i < _numBlocks; i++) {
+    result += _blocks[i].used;
+  }
+
+  return result;
+}
+
+FrameView FrameStore::push_back(const LineInfo& info)
+{
+  const uint8_t len = std::min<uint8_t>(info.len, CANFD_MAX_DLEN);
+
+  cs::byte_t *dest = allocate(recordSize(len));
+
+  FrameHeader header;
+  header.time     = info.time.value();
+  header.id       = info.id;
+  header.device   = info.device;
+  header.len      = len;
+  header.len8_dlc = info.len8_dlc;
+  header.fdflags  = info.fdflags;
+  header.flags    = 0;
+
+  if( info.is_canfd ) {
+    header.flags |= FrameHeader::FLAG_CANFD;
+  }
+  if( info.is_ext ) {
+    header.flags |= FrameHeader::FLAG_EXT;
+  }
+  if( info.is_rtr ) {
+    header.flags |= FrameHeader::FLAG_RTR;
+  }
+
+  std::construct_at(reinterpret_cast<FrameHeader*>(dest), header);
+  memcpy(dest + sizeof(FrameHeader), info.data.data(), len);
+
+  _numFrames++;
+
+  return FrameView(reinterpret_cast<const FrameHeader*>(dest));
+}
+
+FrameStore::size_type FrameStore::recordSize(const uint8_t len)
+{
+  return impl_store::align(sizeof(FrameHeader) + len);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+const FrameHeader *FrameStore::const_iterator::header() const
+{
+  const cs::byte_t *base = reinterpret_cast<const cs::byte_t*>(_store->_blocks[_idxBlock].data.get());
+  return reinterpret_cast<const FrameHeader*>(base + _offset);
+}
+
+cs::byte_t *FrameStore::allocate(const size_type size)
+{
+  if( _numBlocks == 0  ||  _blocks[_numBlocks - 1].used + size > _blockSize ) {
+    if( _numBlocks == _blocks.size() ) {
+      Block block;
+      block.data = std::make_unique_for_overwrite<uint64_t[]>(_blockSize/sizeof(uint64_t));
+      _blocks.push_back(std::move(block));
+    }
+
+    _numBlocks++;
+  }
+
+  Block& block = _blocks[_numBlocks - 1];
+
+  cs::byte_t *dest = reinterpret_cast<cs::byte_t*>(block.data.get()) + block.used;
+  block.used += size;
+
+  return dest;
+}
@@ -0,0 +1,189 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#if defined(__AVX2__)
+# define HAVE_HEX_AVX2
+# include <immintrin.h>
+#elif defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+# define HAVE_HEX_SSE2
+# include <emmintrin.h>
+#endif
+
+#include <cstdint>
+
+#include <cs/Text/StringUtil.h>
+
+#include "HexDecode.h"
+
+namespace hex {
+
+  ////// Private /////////////////////////////////////////////////////////////
+
+  namespace impl_hex {
+
+    constexpr std::size_t TWO = 2;
+
+#if defined(HAVE_HEX_AVX2)
+
+    constexpr std::size_t NUM_DIGITS = 32;
+
+    // Returns the bit mask of valid digits; 'value' holds the decoded bytes.
+    inline uint32_t decodeBlock(__m128i& value, const char *first)
+    {
+      const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+      const __m256i lower = _mm256_or_si256(input, _mm256_set1_epi8(0x20));
+
+      const __m256i is_digit = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('0' - 1)),
+                                                _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), input));
+      const __m256i is_alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                                _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+
+      const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)));
+      if( mask != 0xFFFFFFFF ) {
+        return mask;
+      }
+
+      const __m256i nibbles =
+          _mm256_or_si256(_mm256_and_si256(is_digit, _mm256_sub_epi8(input, _mm256_set1_epi8('0'))),
+                          _mm256_and_si256(is_alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+
+      // NOTE: Even digits are the high nibbles; each 16bit lane holds one byte.
+      const __m256i hi = _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), 4);
+      const __m256i lo = _mm256_srli_epi16(nibbles, 8);
+
+      const __m256i packed = _mm256_packus_epi16(_mm256_or_si256(hi, lo), _mm256_setzero_si256());
+      value = _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0xD8));
+
+      return mask;
+    }
+
+    inline constexpr uint32_t ALL_VALID = 0xFFFFFFFF;
+
+#elif defined(HAVE_HEX_SSE2)
+
+    constexpr std::size_t NUM_DIGITS = 16;
+
+    // Returns the bit mask of valid digits; 'value' holds the decoded bytes.
+    inline uint32_t decodeBlock(__m128i& value, const char *first)
+    {
+      const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+      const __m128i lower = _mm_or_si128(input, _mm_set1_epi8(0x20));
+
+      const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)),
+                                             _mm_cmplt_epi8(input, _mm_set1_epi8('9' + 1)));
+      const __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                             _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+      const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)));
+      if( mask != 0xFFFF ) {
+        return mask;
+      }
+
+      const __m128i nibbles =
+          _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(input, _mm_set1_epi8('0'))),
+                       _mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+      // NOTE: Even digits are the high nibbles; each 16bit lane holds one byte.
+      const __m128i hi = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+      const __m128i lo = _mm_srli_epi16(nibbles, 8);
+
+      value = _mm_packus_epi16(_mm_or_si128(hi, lo), _mm_setzero_si128());
+
+      return mask;
+    }
+
+    inline constexpr uint32_t ALL_VALID = 0xFFFF;
+
+#endif
+
+  } // namespace impl_hex
+
+  ////// Public //////////////////////////////////////////////////////////////
+
+  std::size_t decode(cs::byte_t *dest, const std::size_t size,
+                     const char *first, const char *last)
+  {
+    std::size_t count = 0;
+
+#if defined(HAVE_HEX_AVX2)  ||  defined(HAVE_HEX_SSE2)
+    using namespace impl_hex;
+
+    constexpr std::size_t NUM_BYTES = NUM_DIGITS/TWO;
+
+    while( last - first >= static_cast<std::ptrdiff_t>(NUM_DIGITS)  &&
+           count + NUM_DIGITS <= TWO*size ) {
+      __m128i value;
+      if( decodeBlock(value, first) != ALL_VALID ) {
+        break; // NOTE: The end of the run is decoded one digit at a time.
+      }
+
+      if constexpr( NUM_BYTES == 16 ) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), value);
+      } else {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), value);
+      }
+
+      count += NUM_DIGITS;
+      first += NUM_DIGITS;
+      dest  += NUM_BYTES;
+    }
+#endif
+
+    return count + decodeScalar(dest, size - count/impl_hex::TWO, first, last);
+  }
+
+  std::size_t decodeScalar(cs::byte_t *dest, const std::size_t size,
+                           const char *first, const char *last)
+  {
+    constexpr std::size_t TWO = 2;
+
+    std::size_t count = 0;
+    for(; first != last; ++count, ++first) {
+      if( !cs::isHexDigit(*first) ) {
+        break;
+      }
+
+      if( count == TWO*size ) {
+        return count + 1; // NOTE: Buffer exceeded!
+      }
+
+      const cs::byte_t nibble = cs::fromHexChar(*first);
+      if( count%TWO == 0 ) {
+        dest[count/TWO]  = nibble << 4;
+      } else {
+        dest[count/TWO] |= nibble;
+      }
+    }
+
+    return count;
+  }
+
+} // namespace hex
@@ -0,0 +1,403 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+
+#ifdef LOG2PCAP_HAVE_GZIP
+# include <zlib.h>
+#endif
+
+#ifdef LOG2PCAP_HAVE_ZSTD
+# include <zstd.h>
+#endif
+
+#include "InputFile.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_input {
+
+  using Compression = InputFile::Compression;
+  using size_type   = InputFile::size_type;
+
+  constexpr uint8_t MAGIC_GZIP[] = {0x1F, 0x8B};
+  constexpr uint8_t MAGIC_ZSTD[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+  template<std::size_t N>
+  inline bool startsWith(const char *data, const size_type size, const uint8_t (&magic)[N])
+  {
+    return size >= N  &&  memcmp(data, magic, N) == 0;
+  }
+
+  Compression detect(const char *data, const size_type size)
+  {
+    if(        startsWith(data, size, MAGIC_GZIP) ) {
+      return Compression::Gzip;
+    } else if( startsWith(data, size, MAGIC_ZSTD) ) {
+      return Compression::Zstd;
+    }
+    return Compression::None;
+  }
+
+  /*
+   * NOTE: decode() consumes input from [in,inEnd) and produces output into
+   *       [out,outEnd), advancing both pointers; it returns false on corrupt
+   *       input. isEnd() denotes a complete stream (i.e. member or frame).
+   */
+
+  class Decoder {
+  public:
+    virtual ~Decoder() noexcept = default;
+
+    virtual bool decode(const char*& in, const char *inEnd, char*& out, char *outEnd) = 0;
+    virtual bool isEnd() const = 0;
+  };
+
+#ifdef LOG2PCAP_HAVE_GZIP
+
+  class GzipDecoder : public Decoder {
+  public:
+    GzipDecoder() noexcept
+    {
+      // NOTE: 15 + 32 accepts both zlib and gzip headers with the largest window.
+      _is_init = inflateInit2(&_stream, 15 + 32) == Z_OK;
+    }
+
+    ~GzipDecoder() noexcept
+    {
+      if( _is_init ) {
+        inflateEnd(&_stream);
+      }
+    }
+
+    bool decode(const char*& in, const char *inEnd, char*& out, char *outEnd)
+    {
+      constexpr size_type MAX_AVAIL = std::numeric_limits<uInt>::max();
+
+      if( !_is_init ) {
+        return false;
+      }
+
+      // NOTE: Input following a complete member starts the next member.
+      if( _is_end ) {
+        if( in == inEnd ) {
+          return true;
+        }
+
+        if( inflateReset(&_stream) != Z_OK ) {
+          return false;
+        }
+        _is_end = false;
+      }
+
+      _stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+      _stream.avail_in  = static_cast<uInt>(std::min<size_type>(inEnd - in, MAX_AVAIL));
+      _stream.next_out  = reinterpret_cast<Bytef*>(out);
+      _stream.avail_out = static_cast<uInt>(std::min<size_type>(outEnd - out, MAX_AVAIL));
+
+      const int result = inflate(&_stream, Z_NO_FLUSH);
+
+      in  = reinterpret_cast<const char*>(_stream.next_in);
+      out = reinterpret_cast<char*>(_stream.next_out);
+
+      if( result == Z_STREAM_END ) {
+        _is_end = true;
+        return true;
+      }
+
+      return result == Z_OK  ||  result == Z_BUF_ERROR;
+    }
+
+    bool isEnd() const
+    {
+      return _is_end;
+    }
+
+  private:
+    bool     _is_end{false};
+    bool     _is_init{false};
+    z_stream _stream{};
+  };
+
+#endif
+
+#ifdef LOG2PCAP_HAVE_ZSTD
+
+  class ZstdDecoder : public Decoder {
+  public:
+    ZstdDecoder() noexcept
+      : _stream{ZSTD_createDStream()}
+    {
+      if( _stream != nullptr ) {
+        ZSTD_initDStream(_stream);
+      }
+    }
+
+    ~ZstdDecoder() noexcept
+    {
+      ZSTD_freeDStream(_stream);
+    }
+
+    bool decode(const char*& in, const char *inEnd, char*& out, char *outEnd)
+    {
+      if( _stream == nullptr ) {
+        return false;
+      }
+
+      // NOTE: Only further input may start the next frame.
+      if( _is_end  &&  in == inEnd ) {
+        return true;
+      }
+
+      ZSTD_inBuffer  input{in, static_cast<size_type>(inEnd - in), 0};
+      ZSTD_outBuffer output{out, static_cast<size_type>(outEnd - out), 0};
+
+      const size_type result = ZSTD_decompressStream(_stream, &output, &input);
+      if( ZSTD_isError(result) ) {
+        return false;
+      }
+
+      in  += input.pos;
+      out += output.pos;
+
+      // NOTE: Zero denotes a completely decoded and flushed frame.
+      _is_end = result == 0;
+
+      return true;
+    }
+
+    bool isEnd() const
+    {
+      return _is_end;
+    }
+
+  private:
+    bool          _is_end{false};
+    ZSTD_DStream *_stream{nullptr};
+  };
+
+#endif
+
+  std::unique_ptr<Decoder> makeDecoder(const Compression compression)
+  {
+#ifdef LOG2PCAP_HAVE_GZIP
+    if( compression == Compression::Gzip ) {
+      return std::make_unique<GzipDecoder>();
+    }
+#endif
+#ifdef LOG2PCAP_HAVE_ZSTD
+    if( compression == Compression::Zstd ) {
+      return std::make_unique<ZstdDecoder>();
+    }
+#endif
+    return std::unique_ptr<Decoder>();
+  }
+
+} // namespace impl_input
+
+////// public ////////////////////////////////////////////////////////////////
+
+InputFile::InputFile(const size_type blockSize) noexcept
+{
+  try {
+    _block.resize(std::max<size_type>(blockSize, sizeof(impl_input::MAGIC_ZSTD)));
+  } catch(...) {
+    _block.clear();
+  }
+}
+
+InputFile::~InputFile() noexcept
+{
+}
+
+void InputFile::close()
+{
+  _compression = Compression::None;
+  _decoder.reset();
+  _eof = false;
+  _file.close();
+  _first = 0;
+  _is_error = false;
+  _last = 0;
+}
+
+InputFile::Compression InputFile::compression() const
+{
+  return _compression;
+}
+
+bool InputFile::isError() const
+{
+  return _is_error;
+}
+
+bool InputFile::isOpen() const
+{
+  return _file.isOpen();
+}
+
+bool InputFile::open(const std::filesystem::path& path)
+{
+  close();
+
+  if( _block.empty()  ||  !_file.open(path) ) {
+    return false;
+  }
+
+  // NOTE: The first block is handed out by read(), regardless of compression.
+  fill();
+
+  _compression = impl_input::detect(_block.data(), _last);
+  if( _compression != Compression::None ) {
+    _decoder = impl_input::makeDecoder(_compression);
+    if( !_decoder ) {
+      close();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+InputFile::size_type InputFile::read(void *data, const size_type size)
+{
+  if( !isOpen()  ||  _is_error ) {
+    return 0;
+  }
+
+  return _decoder
+      ? readCompressed(static_cast<char*>(data), size)
+      : readPlain(static_cast<char*>(data), size);
+}
+
+InputFile::size_type InputFile::size() const
+{
+  return isOpen()
+      ? _file.size()
+      : 0;
+}
+
+InputFile::Compression InputFile::detect(const std::filesystem::path& path)
+{
+  cs::File file;
+  if( !file.open(path) ) {
+    return Compression::None;
+  }
+
+  char magic[sizeof(impl_input::MAGIC_ZSTD)];
+  const size_type numRead = file.read(magic, sizeof(magic));
+
+  return impl_input::detect(magic, numRead);
+}
+
+bool InputFile::isSupported(const Compression compression)
+{
+#ifdef LOG2PCAP_HAVE_GZIP
+  if( compression == Compression::Gzip ) {
+    return true;
+  }
+#endif
+#ifdef LOG2PCAP_HAVE_ZSTD
+  if( compression == Compression::Zstd ) {
+    return true;
+  }
+#endif
+  return compression == Compression::None;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool InputFile::fill()
+{
+  _first = 0;
+  _last  = _file.read(_block.data(), _block.size());
+  if( _last == 0 ) {
+    _eof = true;
+  }
+
+  return _last > 0;
+}
+
+InputFile::size_type InputFile::readCompressed(char *data, const size_type size)
+{
+  char *out = data;
+  char *end = data + size;
+
+  while( out < end ) {
+    if( _first == _last  &&  !_eof ) {
+      fill();
+    }
+
+    const char *first = _block.data() + _first;
+    const char *last  = _block.data() + _last;
+
+    const char *in = first;
+    char *before = out;
+    if( !_decoder->decode(in, last, out, end) ) {
+      _is_error = true;
+      break;
+    }
+
+    _first += static_cast<size_type>(in - first);
+
+    // NOTE: Without progress, the decoder requires more input.
+    if( in == first  &&  out == before ) {
+      if( _eof ) {
+        _is_error = !_decoder->isEnd();
+        break;
+      }
+
+      if( _first != _last ) {
+        _is_error = true;
+        break;
+      }
+    }
+  } // While Output
+
+  return static_cast<size_type>(out - data);
+}
+
+InputFile::size_type InputFile::readPlain(char *data, const size_type size)
+{
+  // NOTE: Hand out the buffered first block before reading directly.
+  if( _first < _last ) {
+    const size_type numCopy = std::min(size, _last - _first);
+    memcpy(data, _block.data() + _first, numCopy);
+    _first += numCopy;
+    return numCopy;
+  }
+
+  return _file.read(data, size);
+}
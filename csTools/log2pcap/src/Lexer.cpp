@@ -0,0 +1,321 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+
+#include "Lexer.h"
+
+#include "HexDecode.h"
+
+namespace lexer {
+
+  ////// Private /////////////////////////////////////////////////////////////
+
+  namespace impl_lexer {
+
+    namespace chr = std::chrono;
+
+    using      seconds_t = chr::seconds::rep;
+    using microseconds_t = chr::microseconds::rep;
+
+    constexpr auto INVALID_HEXCHAR = std::numeric_limits<cs::byte_t>::max();
+
+    constexpr std::size_t MAX_TIME_DIGITS = std::numeric_limits<seconds_t>::digits10;
+
+    constexpr canid_t MAX_ID_SHIFT = std::numeric_limits<canid_t>::max() >> 4;
+
+    constexpr auto HEX_TABLE = []() -> std::array<cs::byte_t,256> {
+      std::array<cs::byte_t,256> table;
+      table.fill(INVALID_HEXCHAR);
+      for(int i = 0; i < 10; i++) {
+        table['0' + i] = static_cast<cs::byte_t>(i);
+      }
+      for(int i = 0; i < 6; i++) {
+        table['A' + i] = table['a' + i] = static_cast<cs::byte_t>(10 + i);
+      }
+      return table;
+    }();
+
+    inline cs::byte_t fromHexChar(const char ch)
+    {
+      return HEX_TABLE[static_cast<unsigned char>(ch)];
+    }
+
+    inline bool isDigit(const char ch)
+    {
+      return '0' <= ch  &&  ch <= '9';
+    }
+
+    inline std::string_view toView(const char *first, const char *last)
+    {
+      return std::string_view(first, static_cast<std::size_t>(last - first));
+    }
+
+    inline const char *skipSpaces(const char *first, const char *last)
+    {
+      while( first != last  &&  *first == ' ' ) {
+        ++first;
+      }
+      return first;
+    }
+
+    // Scan up to MAX_TIME_DIGITS decimal digits; returns false for an empty or too long run.
+    template<typename T>
+    inline bool scanDecimal(T& result, const char*& first, const char *last)
+    {
+      const char *begin = first;
+
+      result = 0;
+      for(; first != last  &&  isDigit(*first); ++first) {
+        if( static_cast<std::size_t>(first - begin) >= MAX_TIME_DIGITS ) {
+          return false;
+        }
+        result = result*10 + static_cast<T>(*first - '0');
+      }
+
+      return first != begin;
+    }
+
+  } // namespace impl_lexer
+
+  ////// Public //////////////////////////////////////////////////////////////
+
+  LineInfo lexLine(const std::string_view& line,
+                   ParseErrors& errors, const std::size_t lineno,
+                   const FrameFilter *filter)
+  {
+    using namespace impl_lexer;
+
+    constexpr std::size_t   TWO = 2;
+    constexpr std::ptrdiff_t THREE = 3;
+
+    const char *cur = line.data();
+    const char *end = cur + line.size();
+
+    LineInfo info;
+
+    // (0) Sanity Check ////////////////////////////////////////////////////////
+
+    if( cur == end ) {
+      errors.add(ParseErrors::Category::EmptyLine, lineno);
+      return LineInfo();
+    }
+
+    if( *cur != '(' ) {
+      errors.add(ParseErrors::Category::InvalidStart, lineno, *cur);
+      return LineInfo();
+    }
+
+    // (1) Time Stamp //////////////////////////////////////////////////////////
+
+    const char *begTim = ++cur;
+
+    seconds_t secs = 0;
+    microseconds_t usecs = 0;
+
+    bool is_time = scanDecimal(secs, cur, end)  &&  cur != end  &&  *cur == '.';
+    if( is_time ) {
+      ++cur;
+      is_time = scanDecimal(usecs, cur, end)  &&  cur != end  &&  *cur == ')';
+    }
+
+    if( is_time ) {
+      info.time = cs::TimeVal(chr::seconds{secs}, chr::microseconds{usecs});
+      is_time = info.time.isValid();
+    }
+
+    if( !is_time ) {
+      const char *endTim = std::find(cur, end, ')');
+      if( endTim == end ) {
+        errors.add(ParseErrors::Category::IncompleteTime, lineno);
+      } else {
+        errors.add(ParseErrors::Category::InvalidTime, lineno, toView(begTim, endTim));
+      }
+      return LineInfo();
+    }
+
+    ++cur; // ')'
+
+    if( filter != nullptr  &&  !filter->acceptTime(info.time) ) {
+      return LineInfo();
+    }
+
+    // (2) Device //////////////////////////////////////////////////////////////
+
+    cur = skipSpaces(cur, end);
+    if( cur == end ) {
+      errors.add(ParseErrors::Category::MissingDevice, lineno);
+      return LineInfo();
+    }
+
+    const char *begDev = cur;
+    while( cur != end  &&  *cur != ' ' ) {
+      ++cur;
+    }
+
+    if( cur == end ) {
+      errors.add(ParseErrors::Category::InvalidDeviceSeparator, lineno);
+      return LineInfo();
+    }
+
+    info.device = devices::intern(std::string_view(begDev, cur));
+
+    if( filter != nullptr  &&  !filter->acceptDevice(info.device) ) {
+      return LineInfo();
+    }
+
+    // (3) Message ID ////////////////////////////////////////////////////////
+
+    cur = skipSpaces(cur, end);
+    if( cur == end ) {
+      errors.add(ParseErrors::Category::MissingId, lineno);
+      return LineInfo();
+    }
+
+    const char *begId = cur;
+
+    bool is_id = true;
+    for(; cur != end  &&  *cur != '#'; ++cur) {
+      const cs::byte_t nibble = fromHexChar(*cur);
+      if( nibble == INVALID_HEXCHAR  ||  info.id > MAX_ID_SHIFT ) {
+        is_id = false;
+        cur = std::find(cur, end, '#');
+        break;
+      }
+
+      info.id = (info.id << 4) | nibble;
+    }
+
+    if( cur == end ) {
+      errors.add(ParseErrors::Category::InvalidIdSeparator, lineno);
+      return LineInfo();
+    }
+
+    if( !is_id  ||  cur == begId ) {
+      errors.add(ParseErrors::Category::InvalidId, lineno, toView(begId, cur));
+      return LineInfo();
+    }
+
+    info.is_ext = cur - begId > THREE  ||  info.id > CAN_SFF_MASK;
+
+    ++cur; // NOTE: consider '#' part of the ID
+
+    // (4) Message Type: CAN 2.0, RTR, CAN FD ////////////////////////////////
+
+    if( cur != end ) {
+      if(        *cur == '#' ) {
+        info.is_canfd = true;
+        ++cur;
+
+      } else if( *cur == 'R' ) {
+        info.is_rtr = true;
+        ++cur;
+
+      } else if( fromHexChar(*cur) == INVALID_HEXCHAR ) {
+        errors.add(ParseErrors::Category::InvalidType, lineno, *cur);
+        return LineInfo();
+
+      }
+    }
+
+    if( info.is_canfd  ||  info.is_rtr ) {
+      if( cur == end ) {
+        if( !info.is_rtr ) {
+          errors.add(ParseErrors::Category::MissingExtra, lineno);
+          return LineInfo();
+        }
+
+      } else {
+        const cs::byte_t extra = fromHexChar(*cur);
+        if( extra == INVALID_HEXCHAR ) {
+          errors.add(ParseErrors::Category::InvalidExtra, lineno, *cur);
+          return LineInfo();
+        }
+
+        if( info.is_canfd ) {
+          info.fdflags = extra;
+        } else {
+          info.len = extra;
+        }
+
+        ++cur;
+      }
+    }
+
+    // NOTE: The ID is decided upon here; RTR is part of the message type.
+    if( filter != nullptr  &&  !filter->acceptId(FrameFilter::canId(info)) ) {
+      return LineInfo();
+    }
+
+    // (5) Data //////////////////////////////////////////////////////////////
+
+    if( !info.is_rtr ) {
+      const std::size_t count = hex::decode(info.data.data(), info.data.size(), cur, end);
+      if( count > TWO*info.data.size() ) {
+        errors.add(ParseErrors::Category::DataExceeded, lineno);
+        return LineInfo();
+      }
+
+      if( count%TWO != 0 ) {
+        errors.add(ParseErrors::Category::IncompleteData, lineno);
+        return LineInfo();
+      }
+
+      info.len = static_cast<uint8_t>(count/TWO);
+      cur += count;
+    }
+
+    // (6) Raw DLC ///////////////////////////////////////////////////////////
+
+    if( cur != end  &&  *cur == '_' ) {
+      ++cur;
+
+      if( cur == end ) {
+        errors.add(ParseErrors::Category::MissingRawDlc, lineno);
+        return LineInfo();
+      }
+
+      const cs::byte_t dlc = fromHexChar(*cur);
+      if( dlc == INVALID_HEXCHAR ) {
+        errors.add(ParseErrors::Category::InvalidRawDlc, lineno, *cur);
+        return LineInfo();
+      }
+
+      info.len8_dlc = dlc;
+    }
+
+    return info;
+  }
+
+} // namespace lexer
@@ -0,0 +1,202 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "LineReader.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+LineReader::LineReader(const size_type blockSize) noexcept
+{
+  try {
+    _buffer.resize(std::max<size_type>(blockSize, 1));
+  } catch(...) {
+    _buffer.clear();
+  }
+}
+
+LineReader::~LineReader() noexcept
+{
+  close();
+}
+
+void LineReader::close()
+{
+  _file.close();
+  _eof = false;
+  _first = _last = 0;
+  _lineno = 0;
+  _offset = 0;
+}
+
+bool LineReader::isError() const
+{
+  return _file.isError();
+}
+
+bool LineReader::isOpen() const
+{
+  return _file.isOpen();
+}
+
+bool LineReader::open(const std::filesystem::path& path)
+{
+  close();
+
+  if( _buffer.empty() ) {
+    return false;
+  }
+
+  return _file.open(path);
+}
+
+bool LineReader::getLine(std::string& line)
+{
+  std::string_view view;
+  if( !getLine(view) ) {
+    line.clear();
+    return false;
+  }
+
+  line.assign(view);
+
+  return true;
+}
+
+bool LineReader::getLine(std::string_view& line)
+{
+  line = std::string_view();
+
+  if( !isOpen() ) {
+    return false;
+  }
+
+  while( true ) {
+    const char *first = _buffer.data() + _first;
+    const char  *last = _buffer.data() + _last;
+
+    const char *eol = std::find(first, last, '\n');
+    if( eol != last ) { // (1) Ending found in buffer!
+      _first  += eol - first + 1;
+      _offset += eol - first + 1;
+      line = std::string_view(first, eol);
+      break;
+    }
+
+    if( _eof  &&  _follow ) { // (2) Line without ending may yet be completed!
+      _eof = false;
+      return false;
+    }
+
+    if( _eof ) { // (3) Line without ending is the last one!
+      if( first == last ) {
+        return false;
+      }
+      _first   = _last;
+      _offset += last - first;
+      line = std::string_view(first, last);
+      break;
+    }
+
+    if( !fill() ) {
+      return false;
+    }
+  }
+
+  if( line.ends_with('\r') ) {
+    line.remove_suffix(1);
+  }
+
+  _lineno += 1;
+
+  return true;
+}
+
+LineReader::size_type LineReader::lineNo() const
+{
+  return _lineno;
+}
+
+bool LineReader::isFollow() const
+{
+  return _follow;
+}
+
+bool LineReader::isTruncated() const
+{
+  return isOpen()  &&  _file.compression() == InputFile::Compression::None  &&
+      _file.size() < _offset + (_last - _first);
+}
+
+LineReader::size_type LineReader::offset() const
+{
+  return _offset;
+}
+
+void LineReader::setFollow(const bool on)
+{
+  _follow = on;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool LineReader::fill()
+{
+  // (1) Move incomplete line to the front of the buffer /////////////////////
+
+  const size_type numUsed = _last - _first;
+  if( _first > 0 ) {
+    std::copy(_buffer.begin() + _first, _buffer.begin() + _last, _buffer.begin());
+    _first = 0;
+    _last  = numUsed;
+  }
+
+  // (2) Grow buffer if a single line exceeds it /////////////////////////////
+
+  if( numUsed == _buffer.size() ) {
+    try {
+      _buffer.resize(_buffer.size()*2);
+    } catch(...) {
+      return false;
+    }
+  }
+
+  // (3) Read next block /////////////////////////////////////////////////////
+
+  const size_type numRead = _file.read(_buffer.data() + _last, _buffer.size() - _last);
+  if( numRead == 0 ) {
+    _eof = true;
+  }
+  _last += numRead;
+
+  return true;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "LineSplitter.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+LineSplitter::LineSplitter(const std::string_view& text,
+                           const size_type lineno) noexcept
+  : _lineno{lineno}
+  , _text(text)
+{
+}
+
+LineSplitter::~LineSplitter() noexcept
+{
+}
+
+bool LineSplitter::getLine(std::string_view& line)
+{
+  constexpr size_type NPOS = std::string_view::npos;
+  constexpr size_type  ONE = 1;
+
+  line = std::string_view();
+
+  if( _pos >= _text.size() ) {
+    return false;
+  }
+
+  const size_type eol = _text.find('\n', _pos);
+  if( eol != NPOS ) { // (1) Ending found!
+    line = _text.substr(_pos, eol - _pos);
+    _pos = eol + ONE;
+  } else {            // (2) Line without ending is the last one!
+    line = _text.substr(_pos);
+    _pos = _text.size();
+  }
+
+  if( line.ends_with('\r') ) {
+    line.remove_suffix(ONE);
+  }
+
+  _lineno += 1;
+
+  return true;
+}
+
+LineSplitter::size_type LineSplitter::lineNo() const
+{
+  return _lineno;
+}
+
+LineSplitter::size_type LineSplitter::position() const
+{
+  return _pos;
+}
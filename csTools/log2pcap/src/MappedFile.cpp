@@ -0,0 +1,195 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <Windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_mapped {
+
+#ifdef _WIN32
+
+  bool map(const std::filesystem::path& path, void*& data, std::size_t& size)
+  {
+    data = nullptr;
+    size = 0;
+
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if( file == INVALID_HANDLE_VALUE ) {
+      return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if( !GetFileSizeEx(file, &fileSize)  ||  fileSize.QuadPart < 0 ) {
+      CloseHandle(file);
+      return false;
+    }
+
+    // NOTE: Empty files cannot be mapped, but are valid input!
+    if( fileSize.QuadPart == 0 ) {
+      CloseHandle(file);
+      return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if( mapping == nullptr ) {
+      return false;
+    }
+
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // NOTE: The view keeps the mapping alive!
+    if( data == nullptr ) {
+      return false;
+    }
+
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+
+    return true;
+  }
+
+  void unmap(void *data, const std::size_t /*size*/)
+  {
+    UnmapViewOfFile(data);
+  }
+
+#else
+
+  bool map(const std::filesystem::path& path, void*& data, std::size_t& size)
+  {
+    data = nullptr;
+    size = 0;
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if( fd < 0 ) {
+      return false;
+    }
+
+    struct stat st;
+    if( fstat(fd, &st) != 0  ||  !S_ISREG(st.st_mode) ) {
+      ::close(fd);
+      return false;
+    }
+
+    // NOTE: Empty files cannot be mapped, but are valid input!
+    if( st.st_size == 0 ) {
+      ::close(fd);
+      return true;
+    }
+
+    void *addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // NOTE: The mapping keeps the file alive!
+    if( addr == MAP_FAILED ) {
+      return false;
+    }
+
+    data = addr;
+    size = static_cast<std::size_t>(st.st_size);
+
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    return true;
+  }
+
+  void unmap(void *data, const std::size_t size)
+  {
+    munmap(data, size);
+  }
+
+#endif
+
+} // namespace impl_mapped
+
+////// public ////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile() noexcept
+{
+}
+
+MappedFile::~MappedFile() noexcept
+{
+  close();
+}
+
+void MappedFile::close()
+{
+  if( _data != nullptr ) {
+    impl_mapped::unmap(_data, _size);
+  }
+
+  _data = nullptr;
+  _is_open = false;
+  _size = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+  return _is_open;
+}
+
+bool MappedFile::open(const std::filesystem::path& path)
+{
+  close();
+
+  _is_open = impl_mapped::map(path, _data, _size);
+
+  return _is_open;
+}
+
+const char *MappedFile::data() const
+{
+  return static_cast<const char*>(_data);
+}
+
+MappedFile::size_type MappedFile::size() const
+{
+  return _size;
+}
+
+std::string_view MappedFile::view() const
+{
+  return _data != nullptr
+      ? std::string_view(data(), _size)
+      : std::string_view();
+}
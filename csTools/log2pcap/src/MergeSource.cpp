@@ -0,0 +1,192 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <functional>
+
+#include "MergeSource.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+MergeSource::MergeSource(const cs::LoggerPtr& logger,
+                         const parser::ParseFunc parse,
+                         const FrameFilter *filter,
+                         const size_type batchSize,
+                         const size_type blockSize) noexcept
+  : _batchSize{std::max<size_type>(batchSize, 1)}
+  , _blockSize{blockSize}
+  , _filter{filter}
+  , _logger{logger}
+  , _parse{parse}
+{
+}
+
+MergeSource::~MergeSource() noexcept
+{
+  // NOTE: Wait for all outstanding batches; they reference their input!
+  for(InputPtr& input : _inputs) {
+    if( input->next.valid() ) {
+      input->next.wait();
+    }
+  }
+}
+
+bool MergeSource::add(const std::filesystem::path& path)
+{
+  if( _started ) {
+    return false;
+  }
+
+  InputPtr input = std::make_unique<Input>(_blockSize);
+  if( !input->reader.open(path) ) {
+    return false;
+  }
+  input->path = path;
+
+  _inputs.push_back(std::move(input));
+
+  return true;
+}
+
+bool MergeSource::getInfo(LineInfo& info)
+{
+  if( !_started ) {
+    start();
+  }
+
+  if( _heap.empty() ) {
+    return false;
+  }
+
+  std::pop_heap(_heap.begin(), _heap.end(), std::greater<Entry>{});
+  const size_type index = _heap.back().index;
+  _heap.pop_back();
+
+  Input& input = *_inputs[index];
+  (*input.iter++).get(info);
+
+  if( input.iter != input.batch.end()  ||  load(index) ) {
+    push(index);
+  }
+
+  return true;
+}
+
+bool MergeSource::isError() const
+{
+  return std::any_of(_inputs.cbegin(), _inputs.cend(), [](const InputPtr& input) -> bool {
+    return input->reader.isError();
+  });
+}
+
+void MergeSource::reportErrors() const
+{
+  for(const InputPtr& input : _inputs) {
+    input->errors.report(_logger, input->path);
+  }
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void MergeSource::dispatch(Input& input)
+{
+  try {
+    input.next = std::async(std::launch::async, readBatch, &input, _batchSize, _parse, _filter);
+  } catch(...) {
+    input.next = std::async(std::launch::deferred, readBatch, &input, _batchSize, _parse, _filter);
+  }
+}
+
+bool MergeSource::load(const size_type index)
+{
+  Input& input = *_inputs[index];
+
+  input.batch.clear();
+  input.iter = input.batch.begin();
+
+  if( !input.next.valid() ) {
+    return false;
+  }
+
+  input.batch = input.next.get();
+  input.iter  = input.batch.begin();
+
+  // NOTE: A short batch marks the end of the input.
+  if( input.batch.size() == _batchSize ) {
+    dispatch(input);
+  }
+
+  return !input.batch.empty();
+}
+
+void MergeSource::push(const size_type index)
+{
+  const Input& input = *_inputs[index];
+
+  _heap.push_back({(*input.iter).time().value(), index});
+  std::push_heap(_heap.begin(), _heap.end(), std::greater<Entry>{});
+}
+
+void MergeSource::start()
+{
+  _started = true;
+
+  // (1) Parse the first batch of all inputs concurrently ////////////////////
+
+  for(InputPtr& input : _inputs) {
+    dispatch(*input);
+  }
+
+  // (2) Seed heap ///////////////////////////////////////////////////////////
+
+  _heap.reserve(_inputs.size());
+  for(size_type i = 0; i < _inputs.size(); i++) {
+    if( load(i) ) {
+      push(i);
+    }
+  }
+}
+
+MergeSource::Infos MergeSource::readBatch(Input *input, const size_type batchSize,
+                                          const parser::ParseFunc parse,
+                                          const FrameFilter *filter)
+{
+  Infos infos(batchSize*FrameStore::recordSize(CAN_MAX_DLEN));
+
+  parser::LineParser source(input->reader, input->errors, parse, filter);
+
+  LineInfo info;
+  while( infos.size() < batchSize  &&  source.getInfo(info) ) {
+    infos.push_back(info);
+  }
+
+  return infos;
+}
@@ -0,0 +1,369 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include "ParallelPcapWriter.h"
+#include "DeviceTable.h"
+#include "FrameStore.h"
+#include "PCAP.h"
+#include "RandomAccessFile.h"
+#include "Writer.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_parallel {
+
+  using size_type = ParallelPcapWriter::size_type;
+
+  using FilePtr = std::shared_ptr<RandomAccessFile>;
+
+  /*
+   * NOTE: Cursor is the write position after a chunk: the piece written to
+   *       and the file offset past the chunk's last record. Pieces are kept
+   *       open by the chunks still writing to them.
+   */
+
+  struct Cursor {
+    FilePtr         file;
+    Rotation::Piece piece;
+  };
+
+  using Position = std::shared_future<Cursor>;
+
+  /*
+   * NOTE: Pieces are opened in order of their index; all of them are closed
+   *       by ParallelPcapWriter::write() to learn of deferred write errors.
+   */
+
+  struct Pieces {
+    std::vector<FilePtr> files;
+    std::mutex           mutex;
+  };
+
+  struct Context {
+    DeviceId               device{INVALID_DEVICE};
+    ParseErrors           *errors{nullptr};
+    const FrameFilter     *filter{nullptr};
+    cs::LoggerPtr          logger;
+    std::filesystem::path  output;
+    parser::ParseFunc      parse{nullptr};
+    Pieces                *pieces{nullptr};
+    Rotation               rotation;
+  };
+
+  struct Record {
+    size_type size{0};
+    int64_t   time{0};
+  };
+
+  struct Segment {
+    FilePtr   file;
+    size_type first{0};    // within buffer
+    size_type offset{0};   // within file
+    size_type size{0};
+  };
+
+  struct Task {
+    std::promise<Cursor> end;
+    size_type            numFrames{0};
+    std::future<bool>    result;
+  };
+
+  FilePtr openPiece(const Context *context, const size_type index, const size_type reserve)
+  {
+    const std::filesystem::path path = context->rotation.isEnabled()
+        ? Rotation::piecePath(context->output, index)
+        : context->output;
+
+    FilePtr file = std::make_shared<RandomAccessFile>();
+    if( !file->open(path) ) {
+      context->logger->logError(u8"Unable to open file \"{}\"!", path);
+      return FilePtr();
+    }
+
+    const pcap_hdr header = writer::makeHeader();
+    if( !file->write(&header, sizeof(header), 0) ) {
+      context->logger->logError(u8"Unable to write header to \"{}\"!", path);
+      return FilePtr();
+    }
+
+    if( reserve > sizeof(header) ) {
+      file->preallocate(reserve);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(context->pieces->mutex);
+      context->pieces->files.push_back(file);
+    }
+
+    return file;
+  }
+
+  bool writeChunk(const Context *context,
+                  const std::string_view chunk, const size_type lineno,
+                  const Position begin, std::promise<Cursor> *end,
+                  size_type *numFrames)
+  {
+    const Rotation& rotation = context->rotation;
+
+    std::vector<char> buffer;
+    std::vector<Segment> segments;
+
+    try {
+      // (1) Parse chunk /////////////////////////////////////////////////////
+
+      const FrameStore frames = ChunkedParser::parseChunk(chunk, lineno, *context->errors,
+                                                          context->parse, context->filter);
+
+      // (2) Serialize records ///////////////////////////////////////////////
+
+      buffer.resize(frames.size()*writer::MAX_RECORD_SIZE);
+
+      std::vector<Record> records;
+      size_type size = 0;
+
+      LineInfo info;
+      for(const FrameView view : frames) {
+        if( context->device != INVALID_DEVICE  &&  view.device() != context->device ) {
+          continue;
+        }
+
+        view.get(info);
+        const size_type sizeRecord = writer::serialize(buffer.data() + size, info);
+        size += sizeRecord;
+        *numFrames += 1;
+
+        if( rotation.isEnabled() ) {
+          records.push_back({sizeRecord, info.time.value()});
+        }
+      }
+
+      // (3) Position is the prefix sum of all preceding chunks //////////////
+
+      Cursor cursor = begin.get();
+
+      segments.push_back({cursor.file, 0, cursor.piece.size, 0});
+
+      if( !rotation.isEnabled() ) {
+        cursor.piece.size    += size;
+        segments.back().size  = size;
+      }
+
+      size_type pos = 0;
+      for(const Record& record : records) {
+        if( rotation.isDue(cursor.piece, record.size, record.time) ) {
+          // NOTE: The piece is complete; trim it to its final size.
+          if( !cursor.file->resize(cursor.piece.size) ) {
+            context->logger->logError(u8"Unable to write record to \"{}\"!",
+                                      Rotation::piecePath(context->output, cursor.piece.index));
+            throw std::system_error(std::make_error_code(std::errc::io_error));
+          }
+
+          cursor.file = openPiece(context, cursor.piece.index + 1, rotation.maxBytes);
+          if( !cursor.file ) {
+            throw std::system_error(std::make_error_code(std::errc::io_error));
+          }
+
+          cursor.piece = Rotation::Piece{cursor.piece.index + 1, 0, sizeof(pcap_hdr), record.time};
+          segments.push_back({cursor.file, pos, cursor.piece.size, 0});
+        }
+
+        if( cursor.piece.numRecords == 0 ) {
+          cursor.piece.timeFirst = record.time;
+        }
+        cursor.piece.numRecords++;
+        cursor.piece.size += record.size;
+
+        segments.back().size += record.size;
+        pos += record.size;
+      }
+
+      end->set_value(cursor);
+    } catch(...) {
+      // NOTE: Successors must not wait forever for a failed chunk!
+      end->set_exception(std::current_exception());
+      return false;
+    }
+
+    // (4) Write records concurrently ////////////////////////////////////////
+
+    bool ok = true;
+    for(const Segment& segment : segments) {
+      ok = segment.file->write(buffer.data() + segment.first, segment.size, segment.offset)  &&  ok;
+    }
+
+    return ok;
+  }
+
+} // namespace impl_parallel
+
+////// public ////////////////////////////////////////////////////////////////
+
+ParallelPcapWriter::ParallelPcapWriter(const cs::LoggerPtr& logger, ParseErrors& errors,
+                                       const size_type numThreads,
+                                       const parser::ParseFunc parse,
+                                       const FrameFilter *filter,
+                                       const size_type chunkSize) noexcept
+  : _chunkSize{std::max<size_type>(chunkSize, 1)}
+  , _errors{errors}
+  , _filter{filter}
+  , _logger{logger}
+  , _parse{parse}
+{
+  constexpr size_type TWO = 2;
+
+  _maxPending = TWO*(numThreads > 0
+                     ? numThreads
+                     : ChunkedParser::defaultThreads());
+}
+
+ParallelPcapWriter::~ParallelPcapWriter() noexcept
+{
+}
+
+ParallelPcapWriter::size_type ParallelPcapWriter::numFrames() const
+{
+  return _numFrames;
+}
+
+void ParallelPcapWriter::setRotation(const Rotation& rotation)
+{
+  _rotation = rotation;
+}
+
+bool ParallelPcapWriter::write(const std::filesystem::path& output, const std::string_view& text,
+                               const std::string& device)
+{
+  using namespace impl_parallel;
+
+  _numFrames = 0;
+
+  Pieces pieces;
+
+  Context context;
+  context.device   = !device.empty()
+      ? devices::intern(device)
+      : INVALID_DEVICE;
+  context.errors   = &_errors;
+  context.filter   = _filter;
+  context.logger   = _logger;
+  context.output   = output;
+  context.parse    = _parse;
+  context.pieces   = &pieces;
+  context.rotation = _rotation;
+
+  // (1) First piece /////////////////////////////////////////////////////////
+
+  // NOTE: The size of the text is merely an estimate of the file's size;
+  //       the file is trimmed to its actual size after writing.
+  const size_type reserve = _rotation.maxBytes > 0
+      ? std::min(_rotation.maxBytes, sizeof(pcap_hdr) + text.size())
+      : sizeof(pcap_hdr) + text.size();
+
+  Cursor cursor;
+  cursor.file       = openPiece(&context, 0, reserve);
+  cursor.piece.size = sizeof(pcap_hdr);
+  if( !cursor.file ) {
+    return false;
+  }
+
+  std::promise<Cursor> first;
+  first.set_value(std::move(cursor));
+  Position position = first.get_future().share();
+
+  // (2) Dispatch chunks /////////////////////////////////////////////////////
+
+  std::deque<Task> pending;
+  size_type lineno = 0;
+  bool ok = true;
+  size_type pos = 0;
+  while( pos < text.size()  ||  !pending.empty() ) {
+    if( pos < text.size()  &&  pending.size() < _maxPending ) {
+      const std::string_view chunk = ChunkedParser::nextChunk(text, pos, _chunkSize);
+
+      // NOTE: Elements of a std::deque remain in place when appending.
+      Task& task = pending.emplace_back();
+      const Position next = task.end.get_future().share();
+
+      try {
+        task.result = std::async(std::launch::async, writeChunk, &context, chunk, lineno,
+                                 position, &task.end, &task.numFrames);
+      } catch(...) {
+        task.result = std::async(std::launch::deferred, writeChunk, &context, chunk, lineno,
+                                 position, &task.end, &task.numFrames);
+      }
+
+      lineno += std::count(chunk.begin(), chunk.end(), '\n');
+      position = next;
+      continue;
+    }
+
+    ok = pending.front().result.get()  &&  ok;
+    _numFrames += pending.front().numFrames;
+    pending.pop_front();
+  }
+
+  if( !ok ) {
+    _logger->logError(u8"Unable to write record to \"{}\"!", output);
+    return false;
+  }
+
+  // (3) Trim last piece to its final size ///////////////////////////////////
+
+  const Cursor last = position.get();
+  if( !last.file->resize(last.piece.size) ) {
+    _logger->logError(u8"Unable to write record to \"{}\"!", _rotation.isEnabled()
+                      ? Rotation::piecePath(output, last.piece.index)
+                      : output);
+    return false;
+  }
+
+  // (4) Close all pieces ////////////////////////////////////////////////////
+
+  for(size_type i = 0; i < pieces.files.size(); i++) {
+    if( !pieces.files[i]->close() ) {
+      _logger->logError(u8"Unable to write record to \"{}\"!", _rotation.isEnabled()
+                        ? Rotation::piecePath(output, i)
+                        : output);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
@@ -0,0 +1,166 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <format>
+#include <utility>
+
+#include "ParseErrors.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_errors {
+
+  struct CategoryInfo {
+    const char *what;
+    bool        has_text;
+    bool        is_warning;
+  };
+
+  // NOTE: Same order as ParseErrors::Category!
+  constexpr CategoryInfo CATEGORIES[ParseErrors::NUM_CATEGORIES] = {
+    {"Ignoring empty line",                       false, true},
+    {"Ignoring line with invalid start sequence", true,  true},
+    {"Missing time stamp",                        false, false},
+    {"Incomplete time stamp",                     false, false},
+    {"Invalid time stamp",                        true,  false},
+    {"Missing device declaration",                false, false},
+    {"Invalid device separator",                  false, false},
+    {"Missing message ID",                        false, false},
+    {"Invalid ID separator",                      false, false},
+    {"Invalid ID string",                         true,  false},
+    {"Invalid message type",                      true,  false},
+    {"Missing message extra",                     false, false},
+    {"Invalid message extra",                     true,  false},
+    {"Data buffer exceeded",                      false, false},
+    {"Incomplete data",                           false, false},
+    {"Missing raw DLC",                           false, false},
+    {"Invalid raw DLC",                           true,  false}
+  };
+
+} // namespace impl_errors
+
+////// public ////////////////////////////////////////////////////////////////
+
+ParseErrors::ParseErrors(const size_type maxSamples) noexcept
+  : _maxSamples{maxSamples}
+{
+  for(std::atomic<size_type>& count : _counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+
+  _samples.resize(NUM_CATEGORIES*_maxSamples);
+}
+
+ParseErrors::~ParseErrors() noexcept
+{
+}
+
+void ParseErrors::clear()
+{
+  for(std::atomic<size_type>& count : _counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+ParseErrors::size_type ParseErrors::count(const Category category) const
+{
+  return _counts[static_cast<size_type>(category)].load(std::memory_order_relaxed);
+}
+
+/*
+ * NOTE: The samples of all categories are logged in the order of their line
+ *       numbers, each like the message it replaces, but prefixed by the input
+ *       as "<input>:<lineno>: "; thus, samples of concurrent jobs may be told
+ *       apart. Then, the number of lines not shown follows per category.
+ */
+
+void ParseErrors::report(const cs::LoggerPtr& logger, const std::filesystem::path& input) const
+{
+  using namespace impl_errors;
+
+  using Entry = std::pair<const Sample*,size_type>; // (sample, category)
+
+  std::vector<Entry> entries;
+  for(size_type i = 0; i < NUM_CATEGORIES; i++) {
+    const size_type numSamples = std::min(count(static_cast<Category>(i)), _maxSamples);
+    for(size_type j = 0; j < numSamples; j++) {
+      entries.emplace_back(&_samples[i*_maxSamples + j], i);
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) -> bool {
+    return a.first->lineno < b.first->lineno;
+  });
+
+  for(const Entry& entry : entries) {
+    const Sample       *sample = entry.first;
+    const CategoryInfo&   info = CATEGORIES[entry.second];
+
+    const std::string message = info.has_text
+        ? std::format("{} \"{}\"!", info.what, std::string_view(sample->text.data(), sample->size))
+        : std::format("{}!", info.what);
+
+    if( info.is_warning ) {
+      logger->logWarning(u8"{}:{}: {}", input.string(), sample->lineno, message);
+    } else {
+      logger->logError(u8"{}:{}: {}", input.string(), sample->lineno, message);
+    }
+  } // For Each Sample
+
+  for(size_type i = 0; i < NUM_CATEGORIES; i++) {
+    const size_type numLines = count(static_cast<Category>(i));
+    if( numLines <= _maxSamples ) {
+      continue;
+    }
+
+    const CategoryInfo& info = CATEGORIES[i];
+    const size_type  numMore = numLines - _maxSamples;
+
+    if( info.is_warning ) {
+      logger->logWarning(u8"{}: {} more line(s) of \"{}\"!", info.what, numMore, input);
+    } else {
+      logger->logError(u8"{}: {} more line(s) of \"{}\"!", info.what, numMore, input);
+    }
+  } // For Each Category
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void ParseErrors::addSample(const size_type category, const size_type index,
+                            const size_type lineno, const std::string_view& text)
+{
+  Sample& sample = _samples[category*_maxSamples + index];
+
+  sample.lineno = lineno;
+  sample.size   = static_cast<uint8_t>(std::min(text.size(), MAX_SAMPLE_SIZE));
+  std::copy_n(text.data(), sample.size, sample.text.data());
+}
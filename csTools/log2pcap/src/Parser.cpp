@@ -0,0 +1,371 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+
+#include <cs/Math/Numeric.h>
+#include <cs/Text/StringUtil.h>
+#include <cs/Text/StringValue.h>
+
+#include "HexDecode.h"
+#include "Parser.h"
+
+namespace parser {
+
+  constexpr auto INVALID_HEXCHAR = std::numeric_limits<cs::byte_t>::max();
+
+  constexpr auto lambda_is_space()
+  {
+    return [](const char ch) -> bool {
+      return ch == ' ';
+    };
+  }
+
+  bool parseData(LineInfo& result, ConstViewIter& first, const ConstViewIter& last,
+                 ParseErrors& errors, const std::size_t lineno)
+  {
+    constexpr std::size_t TWO = 2;
+
+    result.data.fill(0);
+    result.len = 0;
+
+    const char *begData = std::to_address(first);
+    const char *endData = begData + std::distance(first, last);
+
+    const std::size_t count = hex::decode(result.data.data(), result.data.size(),
+                                          begData, endData);
+    if( count > TWO*result.data.size() ) {
+      errors.add(ParseErrors::Category::DataExceeded, lineno);
+      return false;
+    }
+
+    if( cs::isOdd(count) ) {
+      errors.add(ParseErrors::Category::IncompleteData, lineno);
+      return false;
+    }
+
+    result.len = static_cast<uint8_t>(count/TWO);
+
+    first += count;
+
+    return true;
+  }
+
+  bool parseDevice(DeviceId& result, ConstViewIter& first, const ConstViewIter& last,
+                   ParseErrors& errors, const std::size_t lineno)
+  {
+    result = INVALID_DEVICE;
+
+    const ConstViewIter begDev = std::find_if_not(first, last, lambda_is_space());
+    if( begDev == last ) {
+      errors.add(ParseErrors::Category::MissingDevice, lineno);
+      return false;
+    }
+
+    const ConstViewIter endDev = std::find(begDev, last, ' ');
+    if( endDev == last ) {
+      errors.add(ParseErrors::Category::InvalidDeviceSeparator, lineno);
+      return false;
+    }
+
+    first = endDev;
+
+    result = devices::intern(std::string_view(begDev, endDev));
+
+    return true;
+  }
+
+  bool parseId(LineInfo& result, ConstViewIter& first, const ConstViewIter& last,
+               ParseErrors& errors, const std::size_t lineno)
+  {
+    constexpr std::iter_difference_t<ConstViewIter> THREE = 3;
+
+    result.id = 0;
+    result.is_ext = false;
+
+    const ConstViewIter begId = std::find_if_not(first, last, lambda_is_space());
+    if( begId == last ) {
+      errors.add(ParseErrors::Category::MissingId, lineno);
+      return false;
+    }
+
+    const ConstViewIter endId = std::find(begId, last, '#');
+    if( endId == last ) {
+      errors.add(ParseErrors::Category::InvalidIdSeparator, lineno);
+      return false;
+    }
+
+    const std::string_view idStr(begId, endId);
+    const auto expVal = cs::toValue<canid_t>(idStr, 16);
+    result.id = expVal.value_or(0);
+    if( !expVal.has_value() ) {
+      errors.add(ParseErrors::Category::InvalidId, lineno, idStr);
+      return false;
+    }
+
+    result.is_ext = std::distance(begId, endId) > THREE  ||  result.id > CAN_SFF_MASK;
+
+    first = endId;
+    ++first; // NOTE: consider '#' part of the ID
+
+    return true;
+  }
+
+  bool parseRawDLC(uint8_t& result, ConstViewIter& first, const ConstViewIter& last,
+                   ParseErrors& errors, const std::size_t lineno)
+  {
+    result = 0;
+
+    if( first == last  ||  *first != '_' ) {
+      return true;
+    }
+
+    ++first; // Skip '_'
+
+    if( first == last ) {
+      errors.add(ParseErrors::Category::MissingRawDlc, lineno);
+      return false;
+    }
+
+    result = cs::fromHexChar(*first);
+    if( result == INVALID_HEXCHAR ) {
+      errors.add(ParseErrors::Category::InvalidRawDlc, lineno, *first);
+      return false;
+    }
+
+    ++first;
+
+    return true;
+  }
+
+  std::expected<cs::TimeVal,std::errc> parseTime(const std::string_view& str)
+  {
+    namespace chr = std::chrono;
+
+    using      seconds_t = chr::seconds::rep;
+    using microseconds_t = chr::microseconds::rep;
+
+    using size_type = std::string_view::size_type;
+
+    constexpr size_type NPOS = std::string_view::npos;
+    constexpr size_type  ONE = 1;
+
+    const size_type idxDot = str.find('.');
+    if( idxDot == NPOS ) {
+      return std::unexpected(std::errc::invalid_argument);
+    }
+
+    const auto expSecs = cs::toValue<seconds_t>(str.substr(0, idxDot));
+    if( !expSecs.has_value() ) {
+      return std::unexpected(expSecs.error());
+    }
+
+    const auto expUSecs = cs::toValue<microseconds_t>(str.substr(idxDot + ONE));
+    if( !expUSecs.has_value() ) {
+      return std::unexpected(expUSecs.error());
+    }
+
+    return cs::TimeVal(chr::seconds{expSecs.value()},
+                       chr::microseconds{expUSecs.value()});
+  }
+
+  bool parseTime(cs::TimeVal& result, ConstViewIter& first, const ConstViewIter& last,
+                 ParseErrors& errors, const std::size_t lineno)
+  {
+    result = cs::TimeVal{-1};
+
+    if( *first != '(' ) {
+      errors.add(ParseErrors::Category::MissingTime, lineno);
+      return false;
+    }
+
+    ++first; // parse '('
+
+    const ConstViewIter endTim = std::find(first, last, ')');
+    if( endTim == last ) {
+      errors.add(ParseErrors::Category::IncompleteTime, lineno);
+      return false;
+    }
+
+    const std::string_view timeStr(first, endTim);
+    result = parseTime(timeStr).value_or(cs::TimeVal(-1));
+    if( !result.isValid() ) {
+      errors.add(ParseErrors::Category::InvalidTime, lineno, timeStr);
+      return false;
+    }
+
+    first = endTim;
+    ++first; // parse ')'
+
+    return true;
+  }
+
+  bool parseType(LineInfo& result, ConstViewIter& first, const ConstViewIter& last,
+                 ParseErrors& errors, const std::size_t lineno)
+  {
+    result.fdflags = 0;
+    result.is_canfd = false;
+    result.is_rtr = false;
+    result.len = 0;
+
+    // (1) Message Type //////////////////////////////////////////////////////
+
+    // NOTE: No message type for empty CAN 2.0 messages!
+    if( first == last ) {
+      return true;
+    }
+
+    if(        *first == '#' ) {
+      result.is_canfd = true;
+      ++first;
+
+    } else if( *first == 'R' ) {
+      result.is_rtr = true;
+      ++first;
+
+    } else if( cs::isHexDigit(*first) ) {
+      return true;
+
+    } else {
+      errors.add(ParseErrors::Category::InvalidType, lineno, *first);
+      return false;
+
+    }
+
+    // (2) Message Extra /////////////////////////////////////////////////////
+
+    if( first == last ) {
+      if( result.is_rtr ) {
+        return true;
+      } else {
+        errors.add(ParseErrors::Category::MissingExtra, lineno);
+        return false;
+      }
+    }
+
+    const uint8_t extra = cs::fromHexChar(*first);
+    if( extra == INVALID_HEXCHAR ) {
+      errors.add(ParseErrors::Category::InvalidExtra, lineno, *first);
+      return false;
+    }
+
+    if(        result.is_canfd ) {
+      result.fdflags = extra;
+    } else if( result.is_rtr ) {
+      result.len = extra;
+    }
+
+    ++first;
+
+    return true;
+  }
+
+  LineInfo parseLine(ConstViewIter first, const ConstViewIter& last,
+                     ParseErrors& errors, const std::size_t lineno,
+                     const FrameFilter *filter)
+  {
+    LineInfo info;
+
+    // (0) Sanity Check ////////////////////////////////////////////////////////
+
+    if( first == last ) {
+      errors.add(ParseErrors::Category::EmptyLine, lineno);
+      return LineInfo();
+    }
+
+    if( *first != '(' ) {
+      errors.add(ParseErrors::Category::InvalidStart, lineno, *first);
+      return LineInfo();
+    }
+
+    // (1) Time Stamp //////////////////////////////////////////////////////////
+
+    if( !parseTime(info.time, first, last, errors, lineno) ) {
+      return LineInfo();
+    }
+
+    if( filter != nullptr  &&  !filter->acceptTime(info.time) ) {
+      return LineInfo();
+    }
+
+    // (2) Device //////////////////////////////////////////////////////////////
+
+    if( !parseDevice(info.device, first, last, errors, lineno) ) {
+      return LineInfo();
+    }
+
+    if( filter != nullptr  &&  !filter->acceptDevice(info.device) ) {
+      return LineInfo();
+    }
+
+    // (3) Message ID ////////////////////////////////////////////////////////
+
+    if( !parseId(info, first, last, errors, lineno) ) {
+      return LineInfo();
+    }
+
+    // (4) Message Type: CAN 2.0, RTR, CAN FD ////////////////////////////////
+
+    if( !parseType(info, first, last, errors, lineno) ) {
+      return LineInfo();
+    }
+
+    // NOTE: The ID is decided upon here; RTR is part of the message type.
+    if( filter != nullptr  &&  !filter->acceptId(FrameFilter::canId(info)) ) {
+      return LineInfo();
+    }
+
+    // (5) Parse Data ////////////////////////////////////////////////////////
+
+    if( !info.is_rtr  &&  !parseData(info, first, last, errors, lineno) ) {
+      return LineInfo();
+    }
+
+    // (6) Parse Raw DLC /////////////////////////////////////////////////////
+
+    if( !parseRawDLC(info.len8_dlc, first, last, errors, lineno) ) {
+      return LineInfo();
+    }
+
+    return info;
+  }
+
+  LineInfo parseLine(const std::string_view& line,
+                     ParseErrors& errors, const std::size_t lineno,
+                     const FrameFilter *filter)
+  {
+    return parseLine(line.cbegin(), line.cend(), errors, lineno, filter);
+  }
+
+} // namespace parser
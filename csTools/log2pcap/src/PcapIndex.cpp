@@ -0,0 +1,250 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+
+#include "PcapIndex.h"
+
+#include "BufferedFile.h"
+#include "FrameFilter.h"
+#include "MappedFile.h"
+#include "PCAP.h"
+#include "Writer.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+PcapIndex::PcapIndex(const size_type interval) noexcept
+  : _interval{std::max<size_type>(interval, 1)}
+  , _pcapSize{sizeof(pcap_hdr)}
+{
+}
+
+PcapIndex::~PcapIndex() noexcept
+{
+}
+
+void PcapIndex::add(const uint64_t offset, const LineInfo& info)
+{
+  constexpr int64_t USECS_PER_SEC = 1000000;
+
+  // NOTE: Index the time stamp as stored in the record, i.e. 32bit seconds!
+  const int64_t time =
+      static_cast<int64_t>(static_cast<uint32_t>(info.time.secs().count()))*USECS_PER_SEC +
+      static_cast<int64_t>(info.time.usecs().count());
+
+  if( _blocks.empty()  ||  _blocks.back().count >= _interval ) {
+    _blocks.push_back({offset, offset, 0, time, time});
+  }
+
+  pcapidx_block& block = _blocks.back();
+  block.offset_end = offset + writer::recordSize(info);
+  block.count++;
+  block.time_min = std::min(block.time_min, time);
+  block.time_max = std::max(block.time_max, time);
+
+  _numRecords++;
+  _pcapSize = block.offset_end;
+
+  _counts[FrameFilter::canId(info) & ~CAN_RTR_FLAG]++;
+}
+
+void PcapIndex::clear()
+{
+  _blocks.clear();
+  _counts.clear();
+  _numRecords = 0;
+  _pcapSize = sizeof(pcap_hdr);
+}
+
+const PcapIndex::Blocks& PcapIndex::blocks() const
+{
+  return _blocks;
+}
+
+const PcapIndex::Counts& PcapIndex::counts() const
+{
+  return _counts;
+}
+
+PcapIndex::size_type PcapIndex::interval() const
+{
+  return _interval;
+}
+
+uint64_t PcapIndex::numRecords() const
+{
+  return _numRecords;
+}
+
+uint64_t PcapIndex::pcapSize() const
+{
+  return _pcapSize;
+}
+
+PcapIndex::Blocks PcapIndex::ranges(const cs::TimeVal& from, const cs::TimeVal& to) const
+{
+  const int64_t lower = lowerBound(from);
+  const int64_t upper = upperBound(to);
+
+  Blocks result;
+  for(const pcapidx_block& block : _blocks) {
+    if( block.time_max < lower  ||  block.time_min >= upper ) {
+      continue;
+    }
+
+    // NOTE: Coalesce adjacent blocks to one range.
+    if( !result.empty()  &&  result.back().offset_end == block.offset_begin ) {
+      pcapidx_block& last = result.back();
+      last.offset_end = block.offset_end;
+      last.count     += block.count;
+      last.time_min   = std::min(last.time_min, block.time_min);
+      last.time_max   = std::max(last.time_max, block.time_max);
+    } else {
+      result.push_back(block);
+    }
+  }
+
+  return result;
+}
+
+bool PcapIndex::load(const std::filesystem::path& path)
+{
+  clear();
+
+  MappedFile file;
+  if( !file.open(path)  ||  file.size() < sizeof(pcapidx_hdr) ) {
+    return false;
+  }
+
+  pcapidx_hdr header;
+  memcpy(&header, file.data(), sizeof(pcapidx_hdr));
+
+  if( header.magic_number != PCAPIDX_MAGIC_NUMBER  ||
+      header.version_major != PCAPIDX_VERSION_MAJOR ) {
+    return false;
+  }
+
+  const std::size_t sizeBlocks = header.num_blocks*sizeof(pcapidx_block);
+  const std::size_t sizeCounts = header.num_ids*sizeof(pcapidx_count);
+  if( file.size() != sizeof(pcapidx_hdr) + sizeBlocks + sizeCounts ) {
+    return false;
+  }
+
+  const char *data = file.data() + sizeof(pcapidx_hdr);
+
+  _blocks.resize(header.num_blocks);
+  memcpy(_blocks.data(), data, sizeBlocks);
+  data += sizeBlocks;
+
+  uint64_t numRecords = 0;
+  for(const pcapidx_block& block : _blocks) {
+    numRecords += block.count;
+  }
+
+  if( numRecords != header.num_records ) {
+    clear();
+    return false;
+  }
+
+  for(uint64_t i = 0; i < header.num_ids; i++) {
+    pcapidx_count count;
+    memcpy(&count, data, sizeof(pcapidx_count));
+    data += sizeof(pcapidx_count);
+
+    _counts[count.can_id] = count.count;
+  }
+
+  _interval   = std::max<size_type>(header.interval, 1);
+  _numRecords = header.num_records;
+  _pcapSize   = header.pcap_size;
+
+  return true;
+}
+
+bool PcapIndex::save(const std::filesystem::path& path) const
+{
+  BufferedFile file;
+  if( !file.open(path) ) {
+    return false;
+  }
+
+  pcapidx_hdr header;
+  header.magic_number  = PCAPIDX_MAGIC_NUMBER;
+  header.version_major = PCAPIDX_VERSION_MAJOR;
+  header.version_minor = PCAPIDX_VERSION_MINOR;
+  header.interval      = static_cast<uint32_t>(_interval);
+  header.reserved      = 0;
+  header.num_blocks    = _blocks.size();
+  header.num_ids       = _counts.size();
+  header.pcap_size     = _pcapSize;
+  header.num_records   = _numRecords;
+
+  file.write(&header, sizeof(pcapidx_hdr));
+  file.write(_blocks.data(), _blocks.size()*sizeof(pcapidx_block));
+
+  // NOTE: Store the counts sorted by ID for reproducible output.
+  std::vector<pcapidx_count> counts;
+  counts.reserve(_counts.size());
+  for(const Counts::value_type& entry : _counts) {
+    counts.push_back({entry.first, 0, entry.second});
+  }
+  std::sort(counts.begin(), counts.end(),
+            [](const pcapidx_count& a, const pcapidx_count& b) -> bool {
+    return a.can_id < b.can_id;
+  });
+
+  file.write(counts.data(), counts.size()*sizeof(pcapidx_count));
+
+  return file.close();
+}
+
+int64_t PcapIndex::lowerBound(const cs::TimeVal& from)
+{
+  return from.isValid()
+      ? from.value()
+      : MIN_TIME;
+}
+
+int64_t PcapIndex::upperBound(const cs::TimeVal& to)
+{
+  return to.isValid()
+      ? to.value()
+      : MAX_TIME;
+}
+
+std::filesystem::path PcapIndex::sidecarPath(const std::filesystem::path& pcap)
+{
+  std::filesystem::path result = pcap;
+  result += ".idx";
+  return result;
+}
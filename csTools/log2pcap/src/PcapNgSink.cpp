@@ -0,0 +1,275 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include "PcapNgSink.h"
+
+#include "PCAP.h"
+#include "Writer.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_pcapng {
+
+  constexpr std::size_t SIZE_BLOCK_HEADER  = sizeof(pcapng_block_hdr);
+  constexpr std::size_t SIZE_BLOCK_TRAILER = sizeof(uint32_t);
+  constexpr std::size_t SIZE_OPTION_HEADER = sizeof(pcapng_opt_hdr);
+
+  constexpr std::size_t pad32(const std::size_t size)
+  {
+    constexpr std::size_t THREE = 3;
+
+    return (size + THREE) & ~THREE;
+  }
+
+  inline cs::byte_t *putBlockHeader(cs::byte_t *dest, const uint32_t type, const uint32_t length)
+  {
+    pcapng_block_hdr header;
+    header.block_type         = type;
+    header.block_total_length = length;
+
+    memcpy(dest, &header, SIZE_BLOCK_HEADER);
+
+    return dest + SIZE_BLOCK_HEADER;
+  }
+
+  inline cs::byte_t *putBlockTrailer(cs::byte_t *dest, const uint32_t length)
+  {
+    memcpy(dest, &length, SIZE_BLOCK_TRAILER);
+
+    return dest + SIZE_BLOCK_TRAILER;
+  }
+
+  inline cs::byte_t *putOption(cs::byte_t *dest, const uint16_t code,
+                               const void *value, const std::size_t length)
+  {
+    pcapng_opt_hdr header;
+    header.option_code   = code;
+    header.option_length = static_cast<uint16_t>(length);
+
+    memcpy(dest, &header, SIZE_OPTION_HEADER);
+    dest += SIZE_OPTION_HEADER;
+
+    memset(dest, 0, pad32(length));
+    if( length > 0 ) {
+      memcpy(dest, value, length);
+    }
+
+    return dest + pad32(length);
+  }
+
+} // namespace impl_pcapng
+
+////// public ////////////////////////////////////////////////////////////////
+
+PcapNgSink::~PcapNgSink()
+{
+}
+
+bool PcapNgSink::close()
+{
+  return _file.close();
+}
+
+bool PcapNgSink::flush()
+{
+  return _file.flush();
+}
+
+std::size_t PcapNgSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool PcapNgSink::write(const LineInfo& info)
+{
+  using namespace impl_pcapng;
+
+  constexpr uint64_t USECS_PER_SEC = 1000000;
+  constexpr uint64_t NSECS_PER_USEC = 1000;
+
+  uint32_t id = 0;
+  if( !interfaceId(id, info.device) ) {
+    return false;
+  }
+
+  const std::size_t sizeFrame = info.is_canfd
+      ? CANFD_MTU
+      : CAN_MTU;
+  const std::size_t sizeBlock = SIZE_BLOCK_HEADER + sizeof(pcapng_epb) +
+      pad32(sizeFrame) + SIZE_BLOCK_TRAILER;
+
+  cs::byte_t *dest = _file.reserve(sizeBlock);
+  if( dest == nullptr ) {
+    return false;
+  }
+
+  uint64_t stamp =
+      static_cast<uint64_t>(info.time.secs().count())*USECS_PER_SEC +
+      static_cast<uint64_t>(info.time.usecs().count());
+  if( _nanoseconds ) {
+    stamp *= NSECS_PER_USEC;
+  }
+
+  pcapng_epb epb;
+  epb.interface_id   = id;
+  epb.timestamp_high = static_cast<uint32_t>(stamp >> 32);
+  epb.timestamp_low  = static_cast<uint32_t>(stamp);
+  epb.captured_len   = static_cast<uint32_t>(sizeFrame);
+  epb.orig_len       = static_cast<uint32_t>(sizeFrame);
+
+  cs::byte_t *cur = putBlockHeader(dest, PCAPNG_BLOCK_EPB, static_cast<uint32_t>(sizeBlock));
+  memcpy(cur, &epb, sizeof(pcapng_epb));
+  cur += sizeof(pcapng_epb);
+
+  memset(cur, 0, pad32(sizeFrame));
+  cur += pad32(writer::serializeFrame(cur, info));
+
+  putBlockTrailer(cur, static_cast<uint32_t>(sizeBlock));
+
+  _file.commit(sizeBlock);
+
+  _numFrames++;
+
+  return true;
+}
+
+IFrameSinkPtr PcapNgSink::create(const std::filesystem::path& output,
+                                 const bool nanoseconds)
+{
+  PcapNgSink *sink = new PcapNgSink(nanoseconds);
+  if( !sink->_file.open(output)  ||  !sink->writeSection() ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  return IFrameSinkPtr(sink);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+PcapNgSink::PcapNgSink(const bool nanoseconds)
+  : _nanoseconds{nanoseconds}
+{
+}
+
+bool PcapNgSink::interfaceId(uint32_t& id, const DeviceId device)
+{
+  // NOTE: Consecutive frames usually stem from the same device!
+  if( _lastDevice != INVALID_DEVICE  &&  device == _lastDevice ) {
+    id = _lastId;
+    return true;
+  }
+
+  Interfaces::const_iterator hit = _interfaces.find(device);
+  if( hit == _interfaces.cend() ) {
+    if( !writeInterface(devices::name(device)) ) {
+      return false;
+    }
+
+    hit = _interfaces.emplace(device, static_cast<uint32_t>(_interfaces.size())).first;
+  }
+
+  _lastDevice = device;
+  _lastId     = hit->second;
+
+  id = _lastId;
+
+  return true;
+}
+
+bool PcapNgSink::writeInterface(const std::string& name)
+{
+  using namespace impl_pcapng;
+
+  const uint8_t tsresol = _nanoseconds
+      ? PCAPNG_TSRESOL_NSEC
+      : PCAPNG_TSRESOL_USEC;
+
+  const std::size_t sizeBlock = SIZE_BLOCK_HEADER + sizeof(pcapng_idb) +
+      SIZE_OPTION_HEADER + pad32(name.size()) +
+      SIZE_OPTION_HEADER + pad32(sizeof(tsresol)) +
+      SIZE_OPTION_HEADER +
+      SIZE_BLOCK_TRAILER;
+
+  cs::byte_t *dest = _file.reserve(sizeBlock);
+  if( dest == nullptr ) {
+    return false;
+  }
+
+  pcapng_idb idb;
+  idb.linktype = LINKTYPE_CAN_SOCKETCAN;
+  idb.reserved = 0;
+  idb.snaplen  = 65535;
+
+  cs::byte_t *cur = putBlockHeader(dest, PCAPNG_BLOCK_IDB, static_cast<uint32_t>(sizeBlock));
+  memcpy(cur, &idb, sizeof(pcapng_idb));
+  cur += sizeof(pcapng_idb);
+
+  cur = putOption(cur, PCAPNG_OPT_IF_NAME, name.data(), name.size());
+  cur = putOption(cur, PCAPNG_OPT_IF_TSRESOL, &tsresol, sizeof(tsresol));
+  cur = putOption(cur, PCAPNG_OPT_ENDOFOPT, nullptr, 0);
+
+  putBlockTrailer(cur, static_cast<uint32_t>(sizeBlock));
+
+  _file.commit(sizeBlock);
+
+  return true;
+}
+
+bool PcapNgSink::writeSection()
+{
+  using namespace impl_pcapng;
+
+  constexpr std::size_t SIZE_BLOCK = SIZE_BLOCK_HEADER + sizeof(pcapng_shb) + SIZE_BLOCK_TRAILER;
+
+  cs::byte_t *dest = _file.reserve(SIZE_BLOCK);
+  if( dest == nullptr ) {
+    return false;
+  }
+
+  pcapng_shb shb;
+  shb.byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC;
+  shb.version_major    = PCAPNG_VERSION_MAJOR;
+  shb.version_minor    = PCAPNG_VERSION_MINOR;
+  shb.section_length   = -1;
+
+  cs::byte_t *cur = putBlockHeader(dest, PCAPNG_BLOCK_SHB, static_cast<uint32_t>(SIZE_BLOCK));
+  memcpy(cur, &shb, sizeof(pcapng_shb));
+  cur += sizeof(pcapng_shb);
+
+  putBlockTrailer(cur, static_cast<uint32_t>(SIZE_BLOCK));
+
+  _file.commit(SIZE_BLOCK);
+
+  return true;
+}
@@ -0,0 +1,194 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <chrono>
+
+#include "PcapRangeReader.h"
+
+#include "PCAP.h"
+#include "SocketCAN.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_reader {
+
+  /*
+   * NOTE: A sidecar is current if it matches the pcap file's size and the
+   *       first record of each block lies within the block's time range.
+   */
+
+  bool isCurrent(const PcapIndex& index, const MappedFile& pcap)
+  {
+    constexpr int64_t USECS_PER_SEC = 1000000;
+
+    if( index.pcapSize() != pcap.size() ) {
+      return false;
+    }
+
+    for(const pcapidx_block& block : index.blocks()) {
+      if( block.offset_begin + sizeof(pcaprec_hdr) > block.offset_end  ||
+          block.offset_end > pcap.size() ) {
+        return false;
+      }
+
+      pcaprec_hdr header;
+      memcpy(&header, pcap.data() + block.offset_begin, sizeof(pcaprec_hdr));
+
+      const int64_t time =
+          static_cast<int64_t>(header.ts_sec)*USECS_PER_SEC +
+          static_cast<int64_t>(header.ts_usec);
+      if( (header.incl_len != CAN_MTU  &&  header.incl_len != CANFD_MTU)  ||
+          time < block.time_min  ||  time > block.time_max ) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+} // namespace impl_reader
+
+////// public ////////////////////////////////////////////////////////////////
+
+PcapRangeReader::PcapRangeReader() noexcept
+{
+}
+
+PcapRangeReader::~PcapRangeReader() noexcept
+{
+}
+
+void PcapRangeReader::close()
+{
+  _blocks.clear();
+  _idxBlock = 0;
+  _index.clear();
+  _pcap.close();
+  _pos = 0;
+}
+
+bool PcapRangeReader::open(const std::filesystem::path& pcap)
+{
+  using namespace impl_reader;
+
+  close();
+
+  if( !_pcap.open(pcap)  ||  _pcap.size() < sizeof(pcap_hdr) ) {
+    close();
+    return false;
+  }
+
+  pcap_hdr header;
+  memcpy(&header, _pcap.data(), sizeof(pcap_hdr));
+
+  if( header.magic_number != MAGIC_NUMBER  ||  header.network != LINKTYPE_CAN_SOCKETCAN ) {
+    close();
+    return false;
+  }
+
+  // NOTE: A missing or stale sidecar falls back to scanning the whole file!
+  if( !_index.load(PcapIndex::sidecarPath(pcap))  ||  !isCurrent(_index, _pcap) ) {
+    _index.clear();
+  }
+
+  setRange(cs::TimeVal{-1}, cs::TimeVal{-1});
+
+  return true;
+}
+
+const PcapIndex& PcapRangeReader::index() const
+{
+  return _index;
+}
+
+void PcapRangeReader::setRange(const cs::TimeVal& from, const cs::TimeVal& to)
+{
+  _from = from;
+  _to   = to;
+
+  if( _index.blocks().empty() ) {
+    _blocks = {{sizeof(pcap_hdr), _pcap.size(), 0, PcapIndex::MIN_TIME, PcapIndex::MAX_TIME}};
+  } else {
+    _blocks = _index.ranges(_from, _to);
+  }
+
+  _idxBlock = 0;
+  _pos = !_blocks.empty()
+      ? _blocks.front().offset_begin
+      : 0;
+}
+
+bool PcapRangeReader::getRecord(PcapRecord& record)
+{
+  const int64_t lower = PcapIndex::lowerBound(_from);
+  const int64_t upper = PcapIndex::upperBound(_to);
+
+  const cs::byte_t *data = reinterpret_cast<const cs::byte_t*>(_pcap.data());
+
+  while( _idxBlock < _blocks.size() ) {
+    const pcapidx_block& block = _blocks[_idxBlock];
+
+    if( _pos + sizeof(pcaprec_hdr) > block.offset_end ) {
+      if( ++_idxBlock < _blocks.size() ) {
+        _pos = _blocks[_idxBlock].offset_begin;
+      }
+      continue;
+    }
+
+    pcaprec_hdr header;
+    memcpy(&header, data + _pos, sizeof(pcaprec_hdr));
+
+    const uint64_t offFrame = _pos + sizeof(pcaprec_hdr);
+    if( header.incl_len > block.offset_end - offFrame ) {
+      // NOTE: Truncated record; nothing more to read.
+      _idxBlock = _blocks.size();
+      return false;
+    }
+
+    const cs::TimeVal time(std::chrono::seconds{header.ts_sec},
+                           std::chrono::microseconds{header.ts_usec});
+
+    record.frame  = data + offFrame;
+    record.offset = _pos;
+    record.size   = header.incl_len;
+    record.time   = time;
+
+    _pos = offFrame + header.incl_len;
+
+    if( time.value() >= lower  &&  time.value() < upper ) {
+      return true;
+    }
+  }
+
+  return false;
+}
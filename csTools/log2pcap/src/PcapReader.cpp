@@ -0,0 +1,398 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+
+#include "PcapReader.h"
+
+#include "PCAP.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_pcap {
+
+  template<typename T>
+  inline T load(const cs::byte_t *data)
+  {
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  inline std::size_t pad4(const std::size_t size)
+  {
+    return (size + 3) & ~std::size_t{3};
+  }
+
+  inline cs::TimeVal toTime(const uint64_t secs, const uint64_t usecs)
+  {
+    return cs::TimeVal(std::chrono::seconds{static_cast<int64_t>(secs)},
+                       std::chrono::microseconds{static_cast<int64_t>(usecs)});
+  }
+
+  /*
+   * NOTE: 'tsresol' denotes units of 10^-tsresol seconds; if its MSB is set,
+   *       units of 2^-tsresol seconds.
+   */
+
+  cs::TimeVal fromTimestamp(const uint64_t timestamp, const uint8_t tsresol)
+  {
+    constexpr uint8_t MSB = 0x80;
+
+    if( (tsresol & MSB) != 0 ) {
+      const uint8_t exp = std::min<uint8_t>(tsresol & ~MSB, 63);
+      const uint64_t units = uint64_t{1} << exp;
+
+      const uint64_t frac = timestamp & (units - 1);
+      return toTime(timestamp >> exp,
+                    static_cast<uint64_t>(static_cast<double>(frac)*1e6/static_cast<double>(units)));
+    }
+
+    const uint8_t exp = std::min<uint8_t>(tsresol, 19);
+
+    uint64_t units = 1;
+    for(uint8_t i = 0; i < exp; i++) {
+      units *= 10;
+    }
+
+    uint64_t usecs = timestamp % units;
+    for(uint8_t i = exp; i < PCAPNG_TSRESOL_USEC; i++) {
+      usecs *= 10;
+    }
+    for(uint8_t i = PCAPNG_TSRESOL_USEC; i < exp; i++) {
+      usecs /= 10;
+    }
+
+    return toTime(timestamp/units, usecs);
+  }
+
+} // namespace impl_pcap
+
+////// public ////////////////////////////////////////////////////////////////
+
+PcapReader::PcapReader(const cs::LoggerPtr& logger) noexcept
+  : _logger{logger}
+{
+}
+
+PcapReader::~PcapReader() noexcept
+{
+}
+
+void PcapReader::close()
+{
+  _device = INVALID_DEVICE;
+  _file.close();
+  _interfaces.clear();
+  _is_nsec = false;
+  _is_pcapng = false;
+  _pos = 0;
+}
+
+bool PcapReader::isOpen() const
+{
+  return _file.isOpen();
+}
+
+bool PcapReader::open(const std::filesystem::path& path, const std::string& device)
+{
+  using namespace impl_pcap;
+
+  constexpr std::size_t SIZE_SHB = sizeof(pcapng_block_hdr) + sizeof(pcapng_shb);
+
+  close();
+
+  if( !_file.open(path) ) {
+    return false;
+  }
+
+  _device = devices::intern(device);
+
+  const cs::byte_t *data = reinterpret_cast<const cs::byte_t*>(_file.data());
+
+  // (1) pcapng; blocks are read by getPcapNg() /////////////////////////////
+
+  if( _file.size() >= SIZE_SHB  &&  load<uint32_t>(data) == PCAPNG_BLOCK_SHB ) {
+    const pcapng_shb shb = load<pcapng_shb>(data + sizeof(pcapng_block_hdr));
+    if( shb.byte_order_magic != PCAPNG_BYTE_ORDER_MAGIC ) {
+      close();
+      return false;
+    }
+
+    _is_pcapng = true;
+
+    return true;
+  }
+
+  // (2) pcap ////////////////////////////////////////////////////////////////
+
+  if( _file.size() < sizeof(pcap_hdr) ) {
+    close();
+    return false;
+  }
+
+  const pcap_hdr header = load<pcap_hdr>(data);
+  if( (header.magic_number != MAGIC_NUMBER  &&  header.magic_number != MAGIC_NUMBER_NSEC)  ||
+      header.network != LINKTYPE_CAN_SOCKETCAN ) {
+    close();
+    return false;
+  }
+
+  _is_nsec = header.magic_number == MAGIC_NUMBER_NSEC;
+  _pos = sizeof(pcap_hdr);
+
+  return true;
+}
+
+bool PcapReader::getInfo(LineInfo& info)
+{
+  if( !isOpen() ) {
+    return false;
+  }
+
+  return _is_pcapng
+      ? getPcapNg(info)
+      : getPcap(info);
+}
+
+bool PcapReader::decodeFrame(LineInfo& info, const cs::byte_t *frame, const std::size_t size)
+{
+  constexpr std::size_t SIZE_ID = sizeof(canid_t) + 2;
+
+  if( size < SIZE_ID ) {
+    return false;
+  }
+
+  info = LineInfo();
+
+  canid_t can_id = 0;
+  if( size > CAN_MTU ) {
+    canfd_frame fd;
+    memset(&fd, 0, CANFD_MTU);
+    memcpy(&fd, frame, std::min(size, CANFD_MTU));
+
+    can_id = fd.can_id;
+
+    info.fdflags  = fd.flags;
+    info.is_canfd = true;
+    info.len      = std::min<uint8_t>(fd.len, CANFD_MAX_DLEN);
+
+    std::copy(fd.data, fd.data + info.len, info.data.begin());
+  } else {
+    can_frame can;
+    memset(&can, 0, CAN_MTU);
+    memcpy(&can, frame, size);
+
+    can_id = can.can_id;
+
+    info.is_rtr = (can_id & CAN_RTR_FLAG) != 0;
+    info.len    = can.len;
+    if( can.len == CAN_MAX_DLEN  &&  can.len8_dlc > CAN_MAX_DLEN ) {
+      info.len8_dlc = can.len8_dlc;
+    }
+
+    // NOTE: Remote frames carry a length, but no data!
+    if( !info.is_rtr ) {
+      info.len = std::min<uint8_t>(info.len, CAN_MAX_DLEN);
+      std::copy(can.data, can.data + info.len, info.data.begin());
+    }
+  }
+
+  info.is_ext = (can_id & CAN_EFF_FLAG) != 0;
+  info.id     = can_id & (info.is_ext
+                          ? CAN_EFF_MASK
+                          : CAN_SFF_MASK);
+
+  return true;
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool PcapReader::getPcap(LineInfo& info)
+{
+  using namespace impl_pcap;
+
+  const cs::byte_t *data = reinterpret_cast<const cs::byte_t*>(_file.data());
+  const std::size_t size = _file.size();
+
+  while( _pos + sizeof(pcaprec_hdr) <= size ) {
+    const pcaprec_hdr header = load<pcaprec_hdr>(data + _pos);
+
+    const std::size_t offFrame = _pos + sizeof(pcaprec_hdr);
+    if( header.incl_len > size - offFrame ) {
+      break;
+    }
+
+    _pos = offFrame + header.incl_len;
+
+    if( !decodeFrame(info, data + offFrame, header.incl_len) ) {
+      continue;
+    }
+
+    info.device = _device;
+    info.time   = toTime(header.ts_sec, _is_nsec
+                         ? header.ts_usec/1000
+                         : header.ts_usec);
+
+    return true;
+  }
+
+  if( _pos < size ) {
+    _logger->logWarning(u8"Truncated record at offset {}!", _pos);
+    _pos = size;
+  }
+
+  return false;
+}
+
+bool PcapReader::getPcapNg(LineInfo& info)
+{
+  using namespace impl_pcap;
+
+  constexpr std::size_t SIZE_FRAME = sizeof(pcapng_block_hdr) + sizeof(uint32_t);
+
+  const cs::byte_t *data = reinterpret_cast<const cs::byte_t*>(_file.data());
+  const std::size_t size = _file.size();
+
+  while( _pos + sizeof(pcapng_block_hdr) <= size ) {
+    const pcapng_block_hdr block = load<pcapng_block_hdr>(data + _pos);
+
+    const std::size_t length = block.block_total_length;
+    if( length < SIZE_FRAME  ||  length % 4 != 0  ||  length > size - _pos ) {
+      break;
+    }
+
+    const std::size_t offBody = _pos + sizeof(pcapng_block_hdr);
+    const std::size_t lenBody = length - SIZE_FRAME;
+
+    _pos += length;
+
+    if(        block.block_type == PCAPNG_BLOCK_SHB ) {
+      if( lenBody < sizeof(pcapng_shb)  ||
+          load<pcapng_shb>(data + offBody).byte_order_magic != PCAPNG_BYTE_ORDER_MAGIC ) {
+        _logger->logError(u8"Unsupported section at offset {}!", _pos - length);
+        _pos = size;
+        return false;
+      }
+
+      // NOTE: Interface IDs are local to their section.
+      _interfaces.clear();
+
+    } else if( block.block_type == PCAPNG_BLOCK_IDB ) {
+      if( !readInterface(offBody, lenBody) ) {
+        _pos -= length;
+        break;
+      }
+
+    } else if( block.block_type == PCAPNG_BLOCK_EPB ) {
+      if( lenBody < sizeof(pcapng_epb) ) {
+        _pos -= length;
+        break;
+      }
+
+      const pcapng_epb epb = load<pcapng_epb>(data + offBody);
+      if( epb.interface_id >= _interfaces.size()  ||
+          epb.captured_len > lenBody - sizeof(pcapng_epb) ) {
+        continue;
+      }
+
+      const Interface& iface = _interfaces[epb.interface_id];
+      if( !iface.is_can  ||
+          !decodeFrame(info, data + offBody + sizeof(pcapng_epb), epb.captured_len) ) {
+        continue;
+      }
+
+      const uint64_t timestamp = (uint64_t{epb.timestamp_high} << 32) | epb.timestamp_low;
+
+      info.device = iface.device;
+      info.time   = fromTimestamp(timestamp, iface.tsresol);
+
+      return true;
+    }
+  } // For Each Block
+
+  if( _pos < size ) {
+    _logger->logWarning(u8"Invalid block at offset {}!", _pos);
+    _pos = size;
+  }
+
+  return false;
+}
+
+bool PcapReader::readInterface(const std::size_t offset, const std::size_t length)
+{
+  using namespace impl_pcap;
+
+  if( length < sizeof(pcapng_idb) ) {
+    return false;
+  }
+
+  const cs::byte_t *data = reinterpret_cast<const cs::byte_t*>(_file.data());
+
+  const pcapng_idb idb = load<pcapng_idb>(data + offset);
+
+  Interface iface;
+  iface.device  = _device;
+  iface.is_can  = idb.linktype == LINKTYPE_CAN_SOCKETCAN;
+  iface.tsresol = PCAPNG_TSRESOL_USEC;
+
+  const std::size_t end = offset + length;
+
+  std::size_t pos = offset + sizeof(pcapng_idb);
+  while( pos + sizeof(pcapng_opt_hdr) <= end ) {
+    const pcapng_opt_hdr option = load<pcapng_opt_hdr>(data + pos);
+    pos += sizeof(pcapng_opt_hdr);
+
+    if( option.option_code == PCAPNG_OPT_ENDOFOPT  ||  option.option_length > end - pos ) {
+      break;
+    }
+
+    if(        option.option_code == PCAPNG_OPT_IF_NAME ) {
+      std::string_view name(reinterpret_cast<const char*>(data + pos), option.option_length);
+      name = name.substr(0, name.find('\0'));
+      if( !name.empty() ) {
+        iface.device = devices::intern(name);
+      }
+    } else if( option.option_code == PCAPNG_OPT_IF_TSRESOL  &&  option.option_length > 0 ) {
+      iface.tsresol = data[pos];
+    }
+
+    pos += pad4(option.option_length);
+  }
+
+  _interfaces.push_back(iface);
+
+  return true;
+}
@@ -0,0 +1,106 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "PcapSink.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+PcapSink::~PcapSink()
+{
+}
+
+bool PcapSink::close()
+{
+  const bool ok = _writer.close();
+  if( !_index ) {
+    return ok;
+  }
+
+  const bool ok_index = _index->save(PcapIndex::sidecarPath(_output));
+  _index->clear();
+
+  return ok  &&  ok_index;
+}
+
+bool PcapSink::flush()
+{
+  return _writer.flush();
+}
+
+std::size_t PcapSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool PcapSink::write(const LineInfo& info)
+{
+  if( _device != INVALID_DEVICE  &&  info.device != _device ) {
+    return true;
+  }
+
+  const uint64_t offset = _writer.position();
+  if( !_writer.write(info) ) {
+    return false;
+  }
+
+  if( _index ) {
+    _index->add(offset, info);
+  }
+
+  _numFrames++;
+
+  return true;
+}
+
+IFrameSinkPtr PcapSink::create(const std::filesystem::path& output,
+                               const std::string& device,
+                               const bool index)
+{
+  PcapSink *sink = new PcapSink(output, device, index);
+  if( !sink->_writer.open(output) ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  return IFrameSinkPtr(sink);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+PcapSink::PcapSink(const std::filesystem::path& output, const std::string& device,
+                   const bool index)
+  : _device{devices::intern(device)}
+  , _output(output)
+{
+  if( index ) {
+    _index = std::make_unique<PcapIndex>();
+  }
+}
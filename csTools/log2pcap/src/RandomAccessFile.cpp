@@ -0,0 +1,226 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <Windows.h>
+#else
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+
+#include "RandomAccessFile.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_random {
+
+  using size_type = RandomAccessFile::size_type;
+
+  constexpr std::intptr_t INVALID_HANDLE = -1;
+
+#ifdef _WIN32
+
+  inline HANDLE toHandle(const std::intptr_t handle)
+  {
+    return reinterpret_cast<HANDLE>(handle);
+  }
+
+  bool close(const std::intptr_t handle)
+  {
+    return CloseHandle(toHandle(handle)) != FALSE;
+  }
+
+  std::intptr_t open(const std::filesystem::path& path)
+  {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                              nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if( file == INVALID_HANDLE_VALUE ) {
+      return INVALID_HANDLE;
+    }
+
+    return reinterpret_cast<std::intptr_t>(file);
+  }
+
+  bool preallocate(const std::intptr_t handle, const size_type size)
+  {
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+
+    return SetFileInformationByHandle(toHandle(handle), FileAllocationInfo,
+                                      &info, sizeof(info)) != FALSE;
+  }
+
+  bool resize(const std::intptr_t handle, const size_type size)
+  {
+    LARGE_INTEGER pos;
+    pos.QuadPart = static_cast<LONGLONG>(size);
+
+    return SetFilePointerEx(toHandle(handle), pos, nullptr, FILE_BEGIN)  &&
+        SetEndOfFile(toHandle(handle));
+  }
+
+  bool write(const std::intptr_t handle,
+             const char *data, size_type size, size_type offset)
+  {
+    constexpr size_type MAX_WRITE = std::numeric_limits<DWORD>::max();
+
+    while( size > 0 ) {
+      OVERLAPPED overlapped{};
+      overlapped.Offset     = static_cast<DWORD>(offset);
+      overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+
+      DWORD numWritten = 0;
+      if( !WriteFile(toHandle(handle), data, static_cast<DWORD>(std::min(size, MAX_WRITE)),
+                     &numWritten, &overlapped)  ||  numWritten == 0 ) {
+        return false;
+      }
+
+      data   += numWritten;
+      offset += numWritten;
+      size   -= numWritten;
+    }
+
+    return true;
+  }
+
+#else
+
+  bool close(const std::intptr_t handle)
+  {
+    // NOTE: Network file systems may report write errors upon close() only.
+    return ::close(static_cast<int>(handle)) == 0;
+  }
+
+  std::intptr_t open(const std::filesystem::path& path)
+  {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if( fd < 0 ) {
+      return INVALID_HANDLE;
+    }
+
+    return fd;
+  }
+
+  bool preallocate(const std::intptr_t handle, const size_type size)
+  {
+    // NOTE: posix_fallocate() returns an error number instead of setting errno.
+    return posix_fallocate(static_cast<int>(handle), 0, static_cast<off_t>(size)) == 0;
+  }
+
+  bool resize(const std::intptr_t handle, const size_type size)
+  {
+    return ftruncate(static_cast<int>(handle), static_cast<off_t>(size)) == 0;
+  }
+
+  bool write(const std::intptr_t handle,
+             const char *data, size_type size, size_type offset)
+  {
+    while( size > 0 ) {
+      const ssize_t numWritten = pwrite(static_cast<int>(handle), data, size,
+                                        static_cast<off_t>(offset));
+      if( numWritten <= 0 ) {
+        return false;
+      }
+
+      data   += numWritten;
+      offset += static_cast<size_type>(numWritten);
+      size   -= static_cast<size_type>(numWritten);
+    }
+
+    return true;
+  }
+
+#endif
+
+} // namespace impl_random
+
+////// public ////////////////////////////////////////////////////////////////
+
+RandomAccessFile::RandomAccessFile() noexcept
+{
+}
+
+RandomAccessFile::~RandomAccessFile() noexcept
+{
+  close();
+}
+
+bool RandomAccessFile::close()
+{
+  if( !isOpen() ) {
+    return false;
+  }
+
+  const bool ok = impl_random::close(_handle);
+  _handle = impl_random::INVALID_HANDLE;
+
+  return ok;
+}
+
+bool RandomAccessFile::isOpen() const
+{
+  return _handle != impl_random::INVALID_HANDLE;
+}
+
+bool RandomAccessFile::open(const std::filesystem::path& path)
+{
+  close();
+
+  _handle = impl_random::open(path);
+
+  return isOpen();
+}
+
+bool RandomAccessFile::preallocate(const size_type size)
+{
+  return isOpen()  &&  impl_random::preallocate(_handle, size);
+}
+
+bool RandomAccessFile::resize(const size_type size)
+{
+  return isOpen()  &&  impl_random::resize(_handle, size);
+}
+
+bool RandomAccessFile::write(const void *data, const size_type size, const size_type offset) const
+{
+  if( !isOpen() ) {
+    return false;
+  }
+
+  return impl_random::write(_handle, static_cast<const char*>(data), size, offset);
+}
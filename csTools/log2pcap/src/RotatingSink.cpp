@@ -0,0 +1,137 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "RotatingSink.h"
+
+#include "PCAP.h"
+#include "PcapSink.h"
+#include "Writer.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+RotatingSink::~RotatingSink()
+{
+}
+
+bool RotatingSink::close()
+{
+  if( !_sink ) {
+    return true;
+  }
+
+  const bool ok = _sink->close();
+  _sink.reset();
+
+  return ok;
+}
+
+bool RotatingSink::flush()
+{
+  return _sink
+      ? _sink->flush()
+      : false;
+}
+
+std::size_t RotatingSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool RotatingSink::write(const LineInfo& info)
+{
+  if( _device != INVALID_DEVICE  &&  info.device != _device ) {
+    return true;
+  }
+
+  if( !_sink ) {
+    return false;
+  }
+
+  const std::size_t size = writer::recordSize(info);
+  const int64_t     time = info.time.value();
+
+  if( _rotation.isDue(_piece, size, time)  &&  !openPiece(_piece.index + 1) ) {
+    return false;
+  }
+
+  if( !_sink->write(info) ) {
+    return false;
+  }
+
+  if( _piece.numRecords == 0 ) {
+    _piece.timeFirst = time;
+  }
+  _piece.numRecords++;
+  _piece.size += size;
+
+  _numFrames++;
+
+  return true;
+}
+
+IFrameSinkPtr RotatingSink::create(const std::filesystem::path& output,
+                                   const Rotation& rotation,
+                                   const std::string& device,
+                                   const bool index)
+{
+  RotatingSink *sink = new RotatingSink(output, rotation, device, index);
+  if( !sink->openPiece(0) ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  return IFrameSinkPtr(sink);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+RotatingSink::RotatingSink(const std::filesystem::path& output, const Rotation& rotation,
+                           const std::string& device, const bool index)
+  : _device{devices::intern(device)}
+  , _index{index}
+  , _output(output)
+  , _rotation(rotation)
+{
+}
+
+bool RotatingSink::openPiece(const std::size_t index)
+{
+  const bool ok = close();
+
+  // NOTE: Filtering by device was already done.
+  _sink = PcapSink::create(Rotation::piecePath(_output, index), std::string(), _index);
+
+  _piece = Rotation::Piece{};
+  _piece.index = index;
+  _piece.size  = sizeof(pcap_hdr);
+
+  return ok  &&  _sink != nullptr;
+}
@@ -0,0 +1,64 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <format>
+#include <string>
+
+#include "Rotation.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+bool Rotation::isDue(const Piece& piece, const size_type recordSize, const int64_t time) const
+{
+  if( piece.numRecords == 0 ) {
+    return false;
+  }
+
+  if( maxBytes > 0  &&  piece.size + recordSize > maxBytes ) {
+    return true;
+  }
+
+  return maxSpan.count() > 0  &&  time - piece.timeFirst >= maxSpan.count();
+}
+
+bool Rotation::isEnabled() const
+{
+  return maxBytes > 0  ||  maxSpan.count() > 0;
+}
+
+std::filesystem::path Rotation::piecePath(const std::filesystem::path& output,
+                                          const size_type index)
+{
+  std::filesystem::path result = output;
+  result.replace_filename(std::format("{}_{:05}", output.stem().string(), index));
+  result.replace_extension(output.extension());
+  return result;
+}
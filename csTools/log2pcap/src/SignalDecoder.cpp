@@ -0,0 +1,254 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <format>
+#include <fstream>
+#include <map>
+
+#include <cs/Text/StringValue.h>
+#include <cs/Text/TextIO.h>
+
+#include <Encode/Parser.h>
+
+#include "SignalDecoder.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_decoder {
+
+  using size_type  = SignalDecoder::size_type;
+  using value_type = SignalDecoder::value_type;
+
+  constexpr std::size_t MAX_EFF_DIGITS = 8;
+
+  // NOTE: "<id>[:be|:le]", cf. SignalDecoder.
+  bool parseText(canid_t& key, bool& is_be, const std::string_view& text)
+  {
+    std::string_view strId = text;
+    is_be = false;
+
+    const std::size_t pos = text.find(':');
+    if( pos != std::string_view::npos ) {
+      const std::string_view order = text.substr(pos + 1);
+      if(        order == "be" ) {
+        is_be = true;
+      } else if( order != "le" ) {
+        return false;
+      }
+      strId = text.substr(0, pos);
+    }
+
+    if( strId.empty()  ||  strId.size() > MAX_EFF_DIGITS ) {
+      return false;
+    }
+
+    const auto expVal = cs::toValue<canid_t>(strId, 16);
+    if( !expVal ) {
+      return false;
+    }
+
+    const bool is_ext = strId.size() == MAX_EFF_DIGITS;
+    if( expVal.value() > (is_ext ? CAN_EFF_MASK : CAN_SFF_MASK) ) {
+      return false;
+    }
+
+    key = is_ext
+        ? expVal.value() | CAN_EFF_FLAG
+        : expVal.value();
+
+    return true;
+  }
+
+  std::string formatId(const canid_t key)
+  {
+    return (key & CAN_EFF_FLAG) != 0
+        ? std::format("{:08X}", key & CAN_EFF_MASK)
+        : std::format("{:03X}", key);
+  }
+
+  inline value_type toWord(const uint8_t *data, const size_type numBytes, const bool is_be)
+  {
+    value_type word = 0;
+    if( is_be ) {
+      for(size_type i = 0; i < numBytes; i++) {
+        word = (word << 8) | data[i];
+      }
+    } else {
+      for(size_type i = numBytes; i > 0; i--) {
+        word = (word << 8) | data[i - 1];
+      }
+    }
+    return word;
+  }
+
+} // namespace impl_decoder
+
+////// public ////////////////////////////////////////////////////////////////
+
+SignalDecoder::SignalDecoder() noexcept
+{
+}
+
+SignalDecoder::~SignalDecoder() noexcept
+{
+}
+
+/*
+ * NOTE: The values of all matching definitions are appended to 'result'; a
+ *       definition requires at least numBits/8 bytes of payload.
+ */
+
+bool SignalDecoder::decode(Values& result, const LineInfo& info) const
+{
+  using namespace impl_decoder;
+
+  result.clear();
+
+  if( info.is_rtr ) {
+    return false;
+  }
+
+  const canid_t key = info.is_ext
+      ? info.id | CAN_EFF_FLAG
+      : info.id;
+
+  const Messages::const_iterator hit = _messages.find(key);
+  if( hit == _messages.cend() ) {
+    return false;
+  }
+
+  for(const Message& msg : hit->second) {
+    if( info.len < msg.numBytes ) {
+      continue;
+    }
+
+    const value_type word = toWord(info.data.data(), msg.numBytes, msg.is_be);
+    if( !msg.engine->isMatch(word) ) {
+      continue;
+    }
+
+    const size_type base = result.size();
+    for(const size_type signal : msg.signals) {
+      result.push_back({signal, 0});
+    }
+
+    for(const Part& part : msg.parts) {
+      result[base + part.slot].value |= part.field->extract(word);
+    }
+  } // For Each Message
+
+  return !result.empty();
+}
+
+bool SignalDecoder::load(const std::filesystem::path& path, const cs::LoggerPtr& logger)
+{
+  std::ifstream file(path);
+  if( !file.is_open() ) {
+    logger->logError(u8"Unable to open file \"{}\"!", path);
+    return false;
+  }
+
+  const std::string text = cs::readStream(file);
+
+  return parse(text, logger);
+}
+
+const std::string& SignalDecoder::name(const size_type signal) const
+{
+  return _names[signal];
+}
+
+SignalDecoder::size_type SignalDecoder::numSignals() const
+{
+  return _names.size();
+}
+
+bool SignalDecoder::parse(const std::string_view& text, const cs::LoggerPtr& logger)
+{
+  using namespace impl_decoder;
+
+  Encode::Parser<value_type> parser;
+  if( !parser.parse(std::string(text), logger) ) {
+    return false;
+  }
+
+  if( parser.result.empty() ) {
+    logger->logError(u8"No encode definition!");
+    return false;
+  }
+
+  Messages messages;
+  std::vector<std::string> names;
+  std::map<std::string,size_type> signals;
+
+  for(EnginePtr& engine : parser.result) {
+    canid_t key = 0;
+    bool is_be = false;
+    if( !parseText(key, is_be, engine->text()) ) {
+      logger->logError(u8"Invalid message \"{}\" of encode definition!", engine->text());
+      return false;
+    }
+
+    Message msg;
+    msg.is_be    = is_be;
+    msg.numBytes = engine->numBits()/8;
+
+    // NOTE: The fields of one variable share the variable's slot.
+    std::map<std::string,size_type> slots;
+    for(const Encode::FieldPtr<value_type>& field : engine->fields()) {
+      const std::string variable = field->name();
+      if( variable.empty() ) {
+        continue;
+      }
+
+      const auto [slot, is_new_slot] = slots.try_emplace(variable, msg.signals.size());
+      if( is_new_slot ) {
+        const auto [signal, is_new_signal] =
+            signals.try_emplace(formatId(key) + "." + variable, names.size());
+        if( is_new_signal ) {
+          names.push_back(signal->first);
+        }
+        msg.signals.push_back(signal->second);
+      }
+
+      msg.parts.push_back({field.get(), slot->second});
+    } // For Each Field
+
+    msg.engine = std::move(engine);
+
+    messages[key].push_back(std::move(msg));
+  } // For Each Engine
+
+  _messages = std::move(messages);
+  _names    = std::move(names);
+
+  return true;
+}
@@ -0,0 +1,205 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <limits>
+
+#include "SignalSink.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_signal {
+
+  constexpr char CSV_HEADER[] = "time,device,signal,value\n";
+
+  inline uint64_t seriesKey(const DeviceId device, const std::size_t signal)
+  {
+    return (static_cast<uint64_t>(device) << 32) | static_cast<uint32_t>(signal);
+  }
+
+  template<typename T>
+  inline bool writeColumn(BufferedFile& file, const std::vector<T>& column)
+  {
+    return column.empty()  ||  file.write(column.data(), column.size()*sizeof(T));
+  }
+
+} // namespace impl_signal
+
+////// public ////////////////////////////////////////////////////////////////
+
+SignalSink::~SignalSink()
+{
+}
+
+bool SignalSink::close()
+{
+  if( !_file.isOpen() ) {
+    return true;
+  }
+
+  bool ok = true;
+  if( _format == Format::Binary ) {
+    ok = writeSeries();
+  }
+
+  ok = _file.close()  &&  ok;
+
+  _series.clear();
+  _seriesIndex.clear();
+
+  return ok;
+}
+
+bool SignalSink::flush()
+{
+  // NOTE: Columns are incomplete until close().
+  return _format == Format::Binary  ||  _file.flush();
+}
+
+SignalSink::size_type SignalSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool SignalSink::write(const LineInfo& info)
+{
+  if( !_decoder->decode(_values, info) ) {
+    return true;
+  }
+
+  // NOTE: Frames without signals of the definitions are not counted.
+  _numFrames++;
+
+  if( _format == Format::Binary ) {
+    for(const SignalDecoder::Value& value : _values) {
+      Series& s = series(info.device, value.signal);
+      s.time.push_back(info.time.value());
+      s.value.push_back(value.value);
+    }
+
+    return true;
+  }
+
+  const std::string& device = devices::name(info.device);
+
+  _row.clear();
+  std::back_insert_iterator<std::string> out(_row);
+  for(const SignalDecoder::Value& value : _values) {
+    std::format_to(out, "{}.{:06},{},{},{}\n",
+                   info.time.secs().count(), info.time.usecs().count(),
+                   device, _decoder->name(value.signal), value.value);
+  }
+
+  return _file.write(_row.data(), _row.size());
+}
+
+IFrameSinkPtr SignalSink::create(const std::filesystem::path& output,
+                                 const SignalDecoder *decoder, const Format format)
+{
+  using namespace impl_signal;
+
+  if( decoder == nullptr ) {
+    return IFrameSinkPtr();
+  }
+
+  SignalSink *sink = new SignalSink(decoder, format);
+  if( !sink->_file.open(output) ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  if( format == Format::Csv  &&
+      !sink->_file.write(CSV_HEADER, sizeof(CSV_HEADER) - 1) ) {
+    delete sink;
+    return IFrameSinkPtr();
+  }
+
+  return IFrameSinkPtr(sink);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+SignalSink::SignalSink(const SignalDecoder *decoder, const Format format)
+  : _decoder{decoder}
+  , _format{format}
+{
+}
+
+SignalSink::Series& SignalSink::series(const DeviceId device, const size_type signal)
+{
+  using namespace impl_signal;
+
+  const uint64_t key = seriesKey(device, signal);
+
+  const auto iter = _seriesIndex.find(key);
+  if( iter != _seriesIndex.end() ) {
+    return _series[iter->second];
+  }
+
+  _seriesIndex.emplace(key, _series.size());
+
+  Series& s = _series.emplace_back();
+  s.device = device;
+  s.signal = signal;
+
+  return s;
+}
+
+bool SignalSink::writeSeries()
+{
+  using namespace impl_signal;
+
+  sigcol_hdr header;
+  header.magic_number  = SIGCOL_MAGIC_NUMBER;
+  header.version_major = SIGCOL_VERSION_MAJOR;
+  header.version_minor = SIGCOL_VERSION_MINOR;
+  header.num_series    = _series.size();
+
+  bool ok = _file.write(&header, sizeof(sigcol_hdr));
+
+  for(const Series& s : _series) {
+    const std::string name = std::format("{}.{}",
+                                         devices::name(s.device), _decoder->name(s.signal));
+    const uint16_t length = static_cast<uint16_t>(std::min<std::size_t>(name.size(),
+                                                                        std::numeric_limits<uint16_t>::max()));
+    const uint64_t count = s.time.size();
+
+    ok = _file.write(&length, sizeof(uint16_t))  &&  ok;
+    ok = _file.write(name.data(), length)  &&  ok;
+    ok = _file.write(&count, sizeof(uint64_t))  &&  ok;
+    ok = writeColumn(_file, s.time)  &&  ok;
+    ok = writeColumn(_file, s.value)  &&  ok;
+  }
+
+  return ok;
+}
@@ -0,0 +1,172 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <format>
+#include <iterator>
+
+#include "StatisticsSink.h"
+
+#include "BufferedFile.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace impl_sink {
+
+  constexpr double MSECS_PER_USEC = 0.001;
+  constexpr double PERCENT        = 100.0;
+  constexpr double SECS_PER_USEC  = 0.000001;
+
+  void formatBins(std::string& result, const auto& bins, const char *prefix)
+  {
+    for(std::size_t i = 0; i < bins.size(); i++) {
+      if( bins[i] > 0 ) {
+        std::format_to(std::back_inserter(result), " {}{}:{}", prefix, i, bins[i]);
+      }
+    }
+  }
+
+} // namespace impl_sink
+
+////// public ////////////////////////////////////////////////////////////////
+
+StatisticsSink::~StatisticsSink()
+{
+}
+
+bool StatisticsSink::close()
+{
+  const std::string text = report(_stats);
+
+  BufferedFile file;
+  if( !file.open(_output) ) {
+    return false;
+  }
+
+  file.write(text.data(), text.size());
+
+  return file.close();
+}
+
+bool StatisticsSink::flush()
+{
+  return true;
+}
+
+std::size_t StatisticsSink::numFrames() const
+{
+  return _numFrames;
+}
+
+bool StatisticsSink::write(const LineInfo& info)
+{
+  _stats.add(info);
+  _numFrames++;
+  return true;
+}
+
+const BusStatistics& StatisticsSink::statistics() const
+{
+  return _stats;
+}
+
+/*
+ * NOTE: Report Layout
+ *
+ * Per device: frame counts, covered time span and bus load.
+ * Per ID: count, inter-arrival times [ms] (min/mean/max), DLC distribution
+ *         'd<dlc>:<count>' and jitter histogram 'j<bin>:<count>'.
+ */
+
+std::string StatisticsSink::report(const BusStatistics& stats)
+{
+  using namespace impl_sink;
+
+  std::string result;
+  std::back_insert_iterator<std::string> out(result);
+
+  for(const BusStatistics::Devices::value_type& entry : stats.devices()) {
+    const BusStatistics::DeviceStats& dev = entry.second;
+
+    std::format_to(out, "Device {}: {} frames ({} CAN FD, {} extended, {} RTR, {} reordered)\n",
+                   devices::name(dev.device), dev.count,
+                   dev.countFD, dev.countExt, dev.countRtr, dev.countReordered);
+    std::format_to(out, "  Time span: {:.6f} s\n",
+                   static_cast<double>(dev.last - dev.first)*SECS_PER_USEC);
+    std::format_to(out, "  Bus load: mean {:.2f} %, max {:.2f} % @ {} bit/s, {} bit/s data\n",
+                   dev.meanLoad()*PERCENT, dev.maxLoad()*PERCENT,
+                   stats.timing().bitrate, stats.timing().dataBitrate);
+
+    std::format_to(out, "  {:>8} {:>10} {:>10} {:>10} {:>10}  {}\n",
+                   "ID", "Count", "Min[ms]", "Mean[ms]", "Max[ms]", "DLC/Jitter");
+
+    for(const BusStatistics::IdStats *ids : dev.ids.sorted()) {
+      const bool is_ext = (ids->id & CAN_EFF_FLAG) != 0;
+      const canid_t id = ids->id & CAN_EFF_MASK;
+
+      if( is_ext ) {
+        std::format_to(out, "  {:08X}", id);
+      } else {
+        std::format_to(out, "  {:>8}", std::format("{:03X}", id));
+      }
+
+      if( ids->numGaps > 0 ) {
+        std::format_to(out, " {:>10} {:>10.3f} {:>10.3f} {:>10.3f} ", ids->count,
+                       static_cast<double>(ids->minGap)*MSECS_PER_USEC,
+                       ids->meanGap()*MSECS_PER_USEC,
+                       static_cast<double>(ids->maxGap)*MSECS_PER_USEC);
+      } else {
+        std::format_to(out, " {:>10} {:>10} {:>10} {:>10} ", ids->count, "-", "-", "-");
+      }
+
+      formatBins(result, ids->dlc, "d");
+      formatBins(result, ids->jitter, "j");
+      result.push_back('\n');
+    } // For Each ID
+
+    result.push_back('\n');
+  } // For Each Device
+
+  return result;
+}
+
+IFrameSinkPtr StatisticsSink::create(const std::filesystem::path& output,
+                                     const BusTiming& timing)
+{
+  return IFrameSinkPtr(new StatisticsSink(output, timing));
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+StatisticsSink::StatisticsSink(const std::filesystem::path& output, const BusTiming& timing)
+  : _output(output)
+  , _stats(timing)
+{
+}
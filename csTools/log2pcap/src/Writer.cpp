@@ -0,0 +1,231 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <algorithm>
+
+#include "Writer.h"
+
+namespace writer {
+
+  pcap_hdr makeHeader()
+  {
+    constexpr auto SIZE_HEADER = sizeof(pcap_hdr);
+
+    pcap_hdr header;
+    memset(&header, 0, SIZE_HEADER);
+
+    /*
+     * NOTE: cf. to the following link for the value of '.snaplen':
+     *
+     * https://www.wireshark.org/docs/wsug_html_chunked/AppToolstcpdump.html
+     */
+
+    header.magic_number  = MAGIC_NUMBER;
+    header.version_major = VERSION_MAJOR;
+    header.version_minor = VERSION_MINOR;
+    header.snaplen       = 65535;
+    header.network       = LINKTYPE_CAN_SOCKETCAN;
+
+    return header;
+  }
+
+  std::size_t recordSize(const LineInfo& info)
+  {
+    return info.is_canfd
+        ? RECORD_SIZE_CANFD
+        : RECORD_SIZE_CAN;
+  }
+
+  std::size_t serialize(void *dest, const LineInfo& info)
+  {
+    return info.is_canfd
+        ? serializeFD(dest, info)
+        : serializeCAN(dest, info);
+  }
+
+  std::size_t serializeCAN(void *dest, const LineInfo& info)
+  {
+    constexpr auto SIZE_HEADER = sizeof(pcaprec_hdr);
+
+    pcaprec_hdr header;
+    memset(&header, 0, SIZE_HEADER);
+
+    header.ts_sec   = info.time.secs().count();
+    header.ts_usec  = info.time.usecs().count();
+    header.incl_len = CAN_MTU;
+    header.orig_len = CAN_MTU;
+
+    cs::byte_t *record = static_cast<cs::byte_t*>(dest);
+    memcpy(record, &header, SIZE_HEADER);
+    serializeFrameCAN(record + SIZE_HEADER, info);
+
+    return RECORD_SIZE_CAN;
+  }
+
+  std::size_t serializeFD(void *dest, const LineInfo& info)
+  {
+    constexpr auto SIZE_HEADER = sizeof(pcaprec_hdr);
+
+    pcaprec_hdr header;
+    memset(&header, 0, SIZE_HEADER);
+
+    header.ts_sec   = info.time.secs().count();
+    header.ts_usec  = info.time.usecs().count();
+    header.incl_len = CANFD_MTU;
+    header.orig_len = CANFD_MTU;
+
+    cs::byte_t *record = static_cast<cs::byte_t*>(dest);
+    memcpy(record, &header, SIZE_HEADER);
+    serializeFrameFD(record + SIZE_HEADER, info);
+
+    return RECORD_SIZE_CANFD;
+  }
+
+  std::size_t serializeFrame(void *dest, const LineInfo& info)
+  {
+    return info.is_canfd
+        ? serializeFrameFD(dest, info)
+        : serializeFrameCAN(dest, info);
+  }
+
+  std::size_t serializeFrameCAN(void *dest, const LineInfo& info)
+  {
+    can_frame frame;
+    memset(&frame, 0, CAN_MTU);
+
+    frame.can_id = info.id;
+    frame.len    = info.len;
+
+    if( info.is_ext ) {
+      frame.can_id |= CAN_EFF_FLAG;
+    }
+
+    if( info.is_rtr ) {
+      frame.can_id |= CAN_RTR_FLAG;
+    }
+
+    if( info.isLen8Dlc() ) {
+      frame.len8_dlc = info.len8_dlc;
+    }
+
+    // NOTE: A classic frame may be logged with more than CAN_MAX_DLEN bytes!
+    if( !info.is_rtr ) {
+      const uint8_t len = std::min<uint8_t>(frame.len, CAN_MAX_DLEN);
+      for(uint8_t i = 0; i < len; i++) {
+        frame.data[i] = info.data[i];
+      }
+    }
+
+    memcpy(dest, &frame, CAN_MTU);
+
+    return CAN_MTU;
+  }
+
+  std::size_t serializeFrameFD(void *dest, const LineInfo& info)
+  {
+    canfd_frame frame;
+    memset(&frame, 0, CANFD_MTU);
+
+    frame.can_id = info.id;
+    frame.len    = info.len;
+    frame.flags  = info.fdflags;
+
+    if( info.is_ext ) {
+      frame.can_id |= CAN_EFF_FLAG;
+    }
+
+    for(uint8_t i = 0; i < frame.len; i++) {
+      frame.data[i] = info.data[i];
+    }
+
+    memcpy(dest, &frame, CANFD_MTU);
+
+    return CANFD_MTU;
+  }
+
+  ////// PcapWriter - public /////////////////////////////////////////////////
+
+  PcapWriter::PcapWriter(const size_type bufferSize) noexcept
+    : _file(std::max<size_type>(bufferSize, MAX_RECORD_SIZE))
+  {
+  }
+
+  PcapWriter::~PcapWriter() noexcept
+  {
+    close();
+  }
+
+  bool PcapWriter::close()
+  {
+    return _file.close();
+  }
+
+  bool PcapWriter::flush()
+  {
+    return _file.flush();
+  }
+
+  bool PcapWriter::isOpen() const
+  {
+    return _file.isOpen();
+  }
+
+  bool PcapWriter::open(const std::filesystem::path& path)
+  {
+    if( !_file.open(path) ) {
+      return false;
+    }
+
+    const pcap_hdr header = makeHeader();
+
+    return _file.write(&header, sizeof(pcap_hdr));
+  }
+
+  PcapWriter::size_type PcapWriter::position() const
+  {
+    return _file.position();
+  }
+
+  bool PcapWriter::write(const LineInfo& info)
+  {
+    cs::byte_t *dest = _file.reserve(MAX_RECORD_SIZE);
+    if( dest == nullptr ) {
+      return false;
+    }
+
+    _file.commit(serialize(dest, info));
+
+    return true;
+  }
+
+} // namespace writer
@@ -0,0 +1,168 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <print>
+#include <string_view>
+
+#include <cs/Logging/Logger.h>
+#include <cs/System/PathFormatter.h>
+#include <cs/Text/StringValue.h>
+
+#include "Lexer.h"
+#include "LineSplitter.h"
+#include "MappedFile.h"
+#include "ParseErrors.h"
+#include "Parser.h"
+
+namespace chr = std::chrono;
+namespace  fs = std::filesystem;
+
+bool isEqual(const LineInfo& a, const LineInfo& b)
+{
+  return
+      a.device   == b.device    &&
+      a.fdflags  == b.fdflags   &&
+      a.id       == b.id        &&
+      a.is_canfd == b.is_canfd  &&
+      a.is_ext   == b.is_ext    &&
+      a.is_rtr   == b.is_rtr    &&
+      a.len      == b.len       &&
+      a.len8_dlc == b.len8_dlc  &&
+      a.time.value() == b.time.value()  &&
+      std::equal(a.data.cbegin(), a.data.cbegin() + a.len, b.data.cbegin());
+}
+
+std::size_t verify(const std::string_view& text, const fs::path& input,
+                   const cs::LoggerPtr& logger)
+{
+  using Category = ParseErrors::Category;
+
+  std::size_t numDiff = 0;
+
+  ParseErrors errorsParser;
+  ParseErrors errorsLexer;
+
+  LineSplitter splitter(text);
+
+  std::string_view line;
+  while( splitter.getLine(line) ) {
+    const LineInfo a = parser::parseLine(line, errorsParser, splitter.lineNo());
+    const LineInfo b = lexer::lexLine(line, errorsLexer, splitter.lineNo());
+    if( !isEqual(a, b) ) {
+      logger->logError(splitter.lineNo(), u8"Parser and lexer differ!");
+      numDiff++;
+    }
+  }
+
+  errorsParser.report(logger, input);
+
+  // NOTE: Both report the same messages.
+  for(std::size_t i = 0; i < ParseErrors::NUM_CATEGORIES; i++) {
+    const Category category = static_cast<Category>(i);
+    if( errorsParser.count(category) != errorsLexer.count(category) ) {
+      logger->logError(u8"Parser and lexer differ in messages of category {}!", i);
+      numDiff++;
+    }
+  }
+
+  return numDiff;
+}
+
+void run(const char *name, const std::string_view& text, const std::size_t repetitions,
+         const parser::ParseFunc parse)
+{
+  std::size_t numLines  = 0;
+  std::size_t numFrames = 0;
+
+  ParseErrors errors;
+
+  const chr::steady_clock::time_point start = chr::steady_clock::now();
+
+  for(std::size_t i = 0; i < repetitions; i++) {
+    LineSplitter splitter(text);
+
+    std::string_view line;
+    while( splitter.getLine(line) ) {
+      if( parse(line, errors, splitter.lineNo(), nullptr).isValid() ) {
+        numFrames++;
+      }
+    }
+
+    numLines += splitter.lineNo();
+  }
+
+  const chr::duration<double> elapsed = chr::steady_clock::now() - start;
+  const double secs = std::max(elapsed.count(), 1e-9);
+
+  std::println("{:<8} {:>10} frames {:>10.3f} s {:>10.1f} MB/s {:>12.0f} frames/s {:>8.1f} ns/line",
+               name, numFrames, secs,
+               double(text.size()*repetitions)/secs/1e6,
+               double(numFrames)/secs,
+               secs*1e9/double(std::max<std::size_t>(numLines, 1)));
+}
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  cs::LoggerPtr logger = cs::Logger::make();
+
+  if( argc < 2 ) {
+    std::println("Usage: {} <candump.log> [repetitions]", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const fs::path input = argv[1];
+  const std::size_t repetitions = argc > 2
+      ? std::max<std::size_t>(cs::toValue<std::size_t>(argv[2]).value_or(1), 1)
+      : 1;
+
+  MappedFile mapped;
+  if( !mapped.open(input) ) {
+    logger->logError(u8"Unable to map input \"{}\"!", input);
+    return EXIT_FAILURE;
+  }
+
+  const std::size_t numDiff = verify(mapped.view(), input, logger);
+  if( numDiff > 0 ) {
+    logger->logError(u8"Parser and lexer differ in {} case(s)!", numDiff);
+    return EXIT_FAILURE;
+  }
+
+  run("parser", mapped.view(), repetitions, parser::parseLine);
+  run("lexer",  mapped.view(), repetitions, lexer::lexLine);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,470 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <expected>
+#include <filesystem>
+#include <print>
+#include <set>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <cs/IO/File.h>
+#include <cs/Logging/Logger.h>
+#include <cs/System/PathFormatter.h>
+#include <cs/Text/StringValue.h>
+
+#include "ArchiveReader.h"
+#include "ArchiveSink.h"
+#include "CanArchive.h"
+#include "CandumpWriter.h"
+#include "FrameFilter.h"
+#include "LineReader.h"
+#include "PCAP.h"
+#include "ParseErrors.h"
+#include "Parser.h"
+#include "PcapReader.h"
+
+namespace fs = std::filesystem;
+
+struct Options {
+  std::vector<fs::path> inputs;
+  fs::path              output;
+  std::size_t           blockFrames{ArchiveSink::DEFAULT_BLOCK_FRAMES};
+  std::string           device{"vcan0"};
+  FrameFilter           filter;
+  bool                  count{false};
+  bool                  help{false};
+  bool                  query{false};
+};
+
+const FrameFilter *frameFilter(const Options& opts)
+{
+  if( opts.filter.isEmpty() ) {
+    return nullptr;
+  }
+
+  return &opts.filter;
+}
+
+void printUsage()
+{
+  std::println("Usage: canarchive [options] <input>...");
+  std::println("");
+  std::println("Converts candump logs and pcap/pcapng files of SocketCAN frames to CAN");
+  std::println("archives. With --query, the frames of archives are printed as candump log;");
+  std::println("blocks of an archive that cannot match the filters are skipped.");
+  std::println("");
+  std::println("  -h, --help                Show this help.");
+  std::println("  -o, --output <file>       Output file (default: <input>.cla, resp. standard");
+  std::println("                            output with --query).");
+  std::println("  -q, --query               Print the frames of archives.");
+  std::println("  -c, --count               Print the number of frames matching the query only.");
+  std::println("      --block-frames <n>    Frames per archive block (default: 4096).");
+  std::println("      --device <name>       Device of pcap frames (default: vcan0).");
+  std::println("");
+  std::println("Filters:");
+  std::println("      --filter-device <name>  Accept frames of device <name>.");
+  std::println("      --filter-id <spec>    Accept IDs \"id\", \"id:mask\", \"id~mask\" or \"first-last\".");
+  std::println("      --from <time>         Accept frames at or after <time> (secs.usecs).");
+  std::println("      --to <time>           Accept frames before <time> (secs.usecs).");
+}
+
+bool parseArgs(Options& opts, const int argc, char **argv, const cs::LoggerPtr& logger)
+{
+  cs::TimeVal from{-1};
+  cs::TimeVal to{-1};
+
+  for(int i = 1; i < argc; i++) {
+    const std::string_view arg(argv[i]);
+
+    const bool is_value =
+        arg == "-o"  ||  arg == "--output"  ||  arg == "--block-frames"  ||
+        arg == "--device"  ||  arg == "--filter-device"  ||  arg == "--filter-id"  ||
+        arg == "--from"  ||  arg == "--to";
+    if( is_value  &&  i + 1 >= argc ) {
+      logger->logError(u8"Missing value of option \"{}\"!", arg);
+      return false;
+    }
+
+    if(        !arg.starts_with("-") ) {
+      opts.inputs.emplace_back(arg);
+    } else if( arg == "-h"  ||  arg == "--help" ) {
+      opts.help = true;
+    } else if( arg == "-o"  ||  arg == "--output" ) {
+      opts.output = argv[++i];
+    } else if( arg == "-q"  ||  arg == "--query" ) {
+      opts.query = true;
+    } else if( arg == "-c"  ||  arg == "--count" ) {
+      opts.count = true;
+    } else if( arg == "--block-frames" ) {
+      const std::string_view value(argv[++i]);
+      const auto expVal = cs::toValue<std::size_t>(value);
+      if( !expVal  ||  expVal.value() == 0 ) {
+        logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+        return false;
+      }
+      opts.blockFrames = expVal.value();
+    } else if( arg == "--device" ) {
+      opts.device = argv[++i];
+    } else if( arg == "--filter-device" ) {
+      opts.filter.addDevice(argv[++i]);
+    } else if( arg == "--filter-id" ) {
+      const std::string_view value(argv[++i]);
+      if( !opts.filter.addId(value) ) {
+        logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+        return false;
+      }
+    } else if( arg == "--from"  ||  arg == "--to" ) {
+      const std::string_view value(argv[++i]);
+      const std::expected<cs::TimeVal,std::errc> time = parser::parseTime(value);
+      if( !time ) {
+        logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+        return false;
+      } else if( arg == "--from" ) {
+        from = time.value();
+      } else {
+        to = time.value();
+      }
+    } else {
+      logger->logError(u8"Unknown option \"{}\"!", arg);
+      return false;
+    }
+  }
+
+  opts.filter.setWindow(from, to);
+
+  if( opts.count ) {
+    opts.query = true;
+  }
+
+  return true;
+}
+
+////// Conversion ////////////////////////////////////////////////////////////
+
+uint32_t readMagic(const fs::path& path)
+{
+  cs::File file;
+  if( !file.open(path) ) {
+    return 0;
+  }
+
+  uint32_t magic = 0;
+  if( file.read(&magic, sizeof(magic)) != sizeof(magic) ) {
+    return 0;
+  }
+
+  return magic;
+}
+
+bool isArchive(const fs::path& path)
+{
+  return readMagic(path) == CANARC_MAGIC_NUMBER;
+}
+
+bool isPcap(const fs::path& path)
+{
+  const uint32_t magic = readMagic(path);
+  return magic == MAGIC_NUMBER  ||  magic == MAGIC_NUMBER_NSEC  ||  magic == PCAPNG_BLOCK_SHB;
+}
+
+fs::path outputPath(const fs::path& input)
+{
+  // NOTE: "name.log.gz" becomes "name.cla".
+  fs::path result = input;
+  if( result.extension() == ".gz"  ||  result.extension() == ".zst" ) {
+    result.replace_extension();
+  }
+  result.replace_extension(".cla");
+
+  return result;
+}
+
+template<typename SourceT>
+bool writeInfos(SourceT& source, IFrameSink& sink, const FrameFilter *filter)
+{
+  LineInfo info;
+  while( source.getInfo(info) ) {
+    if( filter != nullptr  &&  !filter->accept(info) ) {
+      continue;
+    }
+
+    if( !sink.write(info) ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool convert(const fs::path& input, IFrameSink& sink,
+             const Options& opts, const cs::LoggerPtr& logger)
+{
+  const FrameFilter *filter = frameFilter(opts);
+
+  if( isPcap(input) ) {
+    PcapReader reader(logger);
+    if( !reader.open(input, opts.device) ) {
+      logger->logError(u8"Unable to read pcap \"{}\"!", input);
+      return false;
+    }
+
+    if( !writeInfos(reader, sink, filter) ) {
+      logger->logError(u8"Unable to write archive!");
+      return false;
+    }
+
+    return true;
+  }
+
+  LineReader reader;
+  if( !reader.open(input) ) {
+    logger->logError(u8"Unable to read input \"{}\"!", input);
+    return false;
+  }
+
+  // NOTE: The parser already applies the filter.
+  ParseErrors errors;
+  parser::LineParser source(reader, errors, parser::parseLine, filter);
+  const bool ok = writeInfos(source, sink, nullptr);
+  errors.report(logger, input);
+  if( !ok ) {
+    logger->logError(u8"Unable to write archive!");
+    return false;
+  }
+
+  if( reader.isError() ) {
+    logger->logError(u8"Corrupt compressed input \"{}\"!", input);
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * NOTE: An output is truncated upon opening it; hence, no output may be an
+ *       input, nor may several inputs share an output. Paths are compared
+ *       after resolving symbolic links.
+ */
+
+bool checkConversion(const Options& opts, const cs::LoggerPtr& logger)
+{
+  const auto normalize = [](const fs::path& path) -> fs::path {
+    std::error_code ec;
+    const fs::path result = fs::weakly_canonical(path, ec);
+    return !ec
+        ? result
+        : fs::absolute(path, ec).lexically_normal();
+  };
+
+  bool ok = true;
+  std::set<fs::path> inputs;
+  for(const fs::path& input : opts.inputs) {
+    if( isArchive(input) ) {
+      logger->logError(u8"Input \"{}\" already is an archive; use \"--query\"!", input);
+      ok = false;
+    }
+    inputs.insert(normalize(input));
+  }
+
+  std::set<fs::path> outputs;
+  for(const fs::path& input : opts.inputs) {
+    const fs::path output = !opts.output.empty()
+        ? opts.output
+        : outputPath(input);
+    const fs::path normal = normalize(output);
+    if(        outputs.insert(normal).second ) {
+      if( inputs.contains(normal) ) {
+        logger->logError(u8"Output \"{}\" would overwrite an input!", output);
+        ok = false;
+      }
+    } else if( opts.output.empty() ) {
+      logger->logError(u8"Output \"{}\" is shared by several inputs!", output);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+bool convertAll(const Options& opts, const cs::LoggerPtr& logger)
+{
+  if( !checkConversion(opts, logger) ) {
+    return false;
+  }
+
+  // NOTE: A single output collects the frames of all inputs in order.
+  if( !opts.output.empty() ) {
+    const IFrameSinkPtr sink = ArchiveSink::create(opts.output, opts.blockFrames);
+    if( !sink ) {
+      logger->logError(u8"Unable to open file \"{}\"!", opts.output);
+      return false;
+    }
+
+    bool ok = true;
+    for(const fs::path& input : opts.inputs) {
+      ok = convert(input, *sink, opts, logger)  &&  ok;
+    }
+
+    if( !sink->close() ) {
+      logger->logError(u8"Unable to write file \"{}\"!", opts.output);
+      ok = false;
+    }
+
+    return ok;
+  }
+
+  bool ok = true;
+  for(const fs::path& input : opts.inputs) {
+    const fs::path output = outputPath(input);
+
+    const IFrameSinkPtr sink = ArchiveSink::create(output, opts.blockFrames);
+    if( !sink ) {
+      logger->logError(u8"Unable to open file \"{}\"!", output);
+      ok = false;
+      continue;
+    }
+
+    ok = convert(input, *sink, opts, logger)  &&  ok;
+
+    if( !sink->close() ) {
+      logger->logError(u8"Unable to write file \"{}\"!", output);
+      ok = false;
+    }
+  }
+
+  return ok;
+}
+
+////// Query /////////////////////////////////////////////////////////////////
+
+bool query(const fs::path& input, CandumpWriter *writer, std::size_t& numFrames,
+           const Options& opts, const cs::LoggerPtr& logger)
+{
+  ArchiveReader reader;
+  if( !reader.open(input) ) {
+    logger->logError(u8"Unable to read archive \"{}\"!", input);
+    return false;
+  }
+
+  reader.setFilter(frameFilter(opts));
+
+  LineInfo info;
+  while( reader.getInfo(info) ) {
+    if( writer != nullptr  &&  !writer->write(info) ) {
+      logger->logError(u8"Unable to write output!");
+      return false;
+    }
+    numFrames++;
+  }
+
+  if( reader.isError() ) {
+    logger->logError(u8"Corrupt archive \"{}\"!", input);
+    return false;
+  }
+
+  if( opts.count ) {
+    std::println(stderr, "{}: {} of {} blocks read", input.string(),
+                 reader.numBlocksRead(), reader.numBlocks());
+  }
+
+  return true;
+}
+
+bool queryAll(const Options& opts, const cs::LoggerPtr& logger)
+{
+  std::FILE *stream = stdout;
+  if( !opts.output.empty()  &&  !opts.count ) {
+    stream = std::fopen(opts.output.string().c_str(), "wb");
+    if( stream == nullptr ) {
+      logger->logError(u8"Unable to open file \"{}\"!", opts.output);
+      return false;
+    }
+  }
+
+  bool ok = true;
+  std::size_t numFrames = 0;
+  {
+    CandumpWriter writer(stream);
+    for(const fs::path& input : opts.inputs) {
+      ok = query(input, opts.count ? nullptr : &writer, numFrames, opts, logger)  &&  ok;
+    }
+
+    if( !writer.flush() ) {
+      logger->logError(u8"Unable to write output!");
+      ok = false;
+    }
+  }
+
+  if( stream != stdout  &&  std::fclose(stream) != 0 ) {
+    logger->logError(u8"Unable to write file \"{}\"!", opts.output);
+    ok = false;
+  }
+
+  if( opts.count ) {
+    std::println("{}", numFrames);
+  }
+
+  return ok;
+}
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
+{
+  cs::LoggerPtr logger = cs::Logger::make();
+
+  Options opts;
+  if( !parseArgs(opts, argc, argv, logger) ) {
+    return EXIT_FAILURE;
+  }
+
+  if( opts.help  ||  opts.inputs.empty() ) {
+    printUsage();
+    return opts.help
+        ? EXIT_SUCCESS
+        : EXIT_FAILURE;
+  }
+
+  const bool ok = opts.query
+      ? queryAll(opts, logger)
+      : convertAll(opts, logger);
+
+  return ok
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
+}
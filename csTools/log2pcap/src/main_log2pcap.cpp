@@ -29,612 +29,1113 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <csignal>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 
 #include <algorithm>
-#include <iterator>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <expected>
+#include <memory>
+#include <optional>
 #include <print>
+#include <set>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
 
-#include <cs/Core/ByteArray.h>
-#include <cs/IO/BufferedReader.h>
-#include <cs/IO/File.h>
 #include <cs/Logging/Logger.h>
-#include <cs/Math/Numeric.h>
-#include <cs/System/FileSystem.h>
 #include <cs/System/PathFormatter.h>
 #include <cs/System/Time.h>
-#include <cs/Text/StringUtil.h>
 #include <cs/Text/StringValue.h>
-#include <cs/Text/TextIO.h>
 
-#include "PCAP.h"
-#include "SocketCAN.h"
+#include "CandumpWriter.h"
+#include "ChunkedParser.h"
+#include "DemuxSink.h"
+#include "FrameFilter.h"
+#include "InputFile.h"
+#include "Lexer.h"
+#include "LineInfo.h"
+#include "LineReader.h"
+#include "LineSplitter.h"
+#include "MappedFile.h"
+#include "MergeSource.h"
+#include "ParallelPcapWriter.h"
+#include "ParseErrors.h"
+#include "Parser.h"
+#include "PcapNgSink.h"
+#include "PcapSink.h"
+#include "ReorderSource.h"
+#include "RotatingSink.h"
+#include "SignalDecoder.h"
+#include "SignalSink.h"
+#include "StatisticsSink.h"
 
 namespace chr = std::chrono;
 namespace  fs = std::filesystem;
 
-using LineData = cs::ByteArray<CANFD_MAX_DLEN>;
-
-struct LineInfo {
-  LineInfo()
-  {
-    data.fill(0);
-  }
+inline fs::path replaceExtension(fs::path p, const fs::path& ext)
+{
+  p.replace_extension(ext);
+  return p;
+}
 
-  bool isValid() const
-  {
-    return !device.empty()  &&  time.isValid();
-  }
+using SignalFormat = SignalSink::Format;
+
+struct Options {
+  std::vector<std::string> inputs;
+  std::shared_ptr<const SignalDecoder> decoder;
+  fs::path          decode;
+  fs::path          output;
+  fs::path          outputDir;
+  std::string       device{"vcan0"};
+  SignalFormat      decodeFormat{SignalFormat::Csv};
+  FrameFilter       filter;
+  Rotation          rotation;
+  BusTiming         timing;
+  chr::milliseconds flushInterval{1000};
+  chr::seconds      idleTimeout{0};
+  chr::milliseconds pollInterval{250};
+  chr::milliseconds reorderHorizon{0};
+  bool              demux{false};
+  bool              echo{false};
+  bool              follow{false};
+  bool              help{false};
+  bool              index{false};
+  bool              lexer{false};
+  bool              mapped{false};
+  bool              merge{false};
+  bool              nanoseconds{false};
+  bool              parallel{false};
+  bool              pcapng{false};
+  bool              pwrite{false};
+  bool              recursive{false};
+  bool              statistics{false};
+  std::size_t       numJobs{0};
+  std::size_t       numThreads{0};
+};
 
-  bool isLen8Dlc() const
-  {
-    return !is_canfd  &&  len == 8  &&  len8_dlc > 8;
+// NOTE: Echoed frames are written to stdout in batches.
+std::unique_ptr<CandumpWriter> makeEcho(const Options& opts)
+{
+  if( !opts.echo ) {
+    return std::unique_ptr<CandumpWriter>();
   }
+  return std::make_unique<CandumpWriter>(stdout);
+}
 
-  LineData    data;
-  std::string device;
-  uint8_t     fdflags{0};
-  canid_t     id{0};
-  bool        is_canfd{false};
-  bool        is_ext{false};
-  bool        is_rtr{false};
-  uint8_t     len{0};
-  uint8_t     len8_dlc{0};
-  cs::TimeVal time{-1};
-};
-
-using LineInfos = std::list<LineInfo>;
+template<typename SourceT>
+bool writeInfos(SourceT& source, IFrameSink& sink, const fs::path& output,
+                const Options& opts, const cs::LoggerPtr& logger,
+                std::size_t& numFrames)
+{
+  const std::unique_ptr<CandumpWriter> echo = makeEcho(opts);
 
-namespace parser {
+  LineInfo info;
+  while( source.getInfo(info) ) {
+    if( echo ) {
+      echo->write(info);
+    }
 
-  using ConstStringIter = std::string::const_iterator;
+    if( !sink.write(info) ) {
+      logger->logError(u8"Unable to write record to \"{}\"!", output);
+      numFrames = sink.numFrames();
+      return false;
+    }
+  } // For Each Frame
 
-  constexpr auto INVALID_HEXCHAR = std::numeric_limits<cs::byte_t>::max();
+  // NOTE: Sinks may skip frames, e.g. of other devices.
+  numFrames = sink.numFrames();
 
-  constexpr auto lambda_is_space()
-  {
-    return [](const char ch) -> bool {
-      return ch == ' ';
-    };
+  if( !sink.close() ) {
+    logger->logError(u8"Unable to write record to \"{}\"!", output);
+    return false;
   }
 
-  bool parseData(LineInfo& result, ConstStringIter& first, const ConstStringIter& last,
-                 const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    constexpr std::size_t TWO = 2;
+  return true;
+}
 
-    result.data.fill(0);
-    result.len = 0;
+void warnLate(const std::size_t numLate, const fs::path& output, const cs::LoggerPtr& logger)
+{
+  if( numLate > 0 ) {
+    logger->logWarning(u8"{} frame(s) of \"{}\" arrived later than the reorder horizon!",
+                       numLate, output);
+  }
+}
 
-    std::size_t count = 0;
-    for(; first != last; ++count, ++first) {
-      const bool is_even = cs::isEven(count);
+template<typename SourceT>
+bool convertInfos(SourceT& source, IFrameSink& sink, const fs::path& output,
+                  const Options& opts, const cs::LoggerPtr& logger,
+                  std::size_t& numFrames)
+{
+  if( opts.reorderHorizon.count() > 0 ) {
+    ReorderSource<SourceT> reorder(source, opts.reorderHorizon);
+    const bool ok = writeInfos(reorder, sink, output, opts, logger, numFrames);
+    warnLate(reorder.numLate(), output, logger);
+    return ok;
+  }
 
-      if( !cs::isHexDigit(*first) ) {
-        if( is_even ) {
-          return true;
-        } else {
-          logger->logError(lineno, u8"Incomplete data!");
-          return false;
-        }
+  return writeInfos(source, sink, output, opts, logger, numFrames);
+}
 
-      } else {
-        const std::size_t idxData = count/TWO;
-        if( idxData >= result.data.size() ) {
-          logger->logError(lineno, u8"Data buffer exceeded!");
-          return false;
-        }
+const char *outputExtension(const Options& opts)
+{
+  if(        !opts.decode.empty() ) {
+    return opts.decodeFormat == SignalFormat::Binary
+        ? "sig"
+        : "csv";
+  } else if( opts.statistics ) {
+    return "stats.txt";
+  } else if( opts.pcapng ) {
+    return "pcapng";
+  }
+  return "pcap";
+}
 
-        result.data[idxData] |= cs::fromHexChar(*first);
-        if( is_even ) {
-          result.data[idxData] <<= 4;
-        } else {
-          result.len++;
-        }
-      }
-    } // For each character
+parser::ParseFunc parseFunc(const Options& opts)
+{
+  if( opts.lexer ) {
+    return lexer::lexLine;
+  }
+  return parser::parseLine;
+}
 
-    if( cs::isOdd(count) ) {
-      logger->logError(lineno, u8"Incomplete data!");
-      return false;
-    }
+const FrameFilter *frameFilter(const Options& opts)
+{
+  if( opts.filter.isEmpty() ) {
+    return nullptr;
+  }
+  return &opts.filter;
+}
 
-    return true;
+IFrameSinkPtr createSink(const fs::path& output,
+                         const Options& opts, const cs::LoggerPtr& logger)
+{
+  IFrameSinkPtr sink;
+  if(        !opts.decode.empty() ) {
+    sink = SignalSink::create(output, opts.decoder.get(), opts.decodeFormat);
+  } else if( opts.statistics ) {
+    sink = StatisticsSink::create(output, opts.timing);
+  } else if( opts.pcapng ) {
+    sink = PcapNgSink::create(output, opts.nanoseconds);
+  } else if( opts.demux ) {
+    sink = DemuxSink::create(output, logger, opts.index);
+  } else if( opts.rotation.isEnabled() ) {
+    sink = RotatingSink::create(output, opts.rotation, opts.device, opts.index);
+  } else {
+    sink = PcapSink::create(output, opts.device, opts.index);
+  }
+  if( !sink ) {
+    logger->logError(u8"Unable to open file \"{}\"!", output);
   }
 
-  bool parseDevice(std::string& result, ConstStringIter& first, const ConstStringIter& last,
-                   const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    result.clear();
+  return sink;
+}
 
-    const ConstStringIter begDev = std::find_if_not(first, last, lambda_is_space());
-    if( begDev == last ) {
-      logger->logError(lineno, u8"Missing device declaration!");
-      return false;
-    }
+bool isPwrite(const Options& opts)
+{
+  // NOTE: Records are written out of order; nothing may observe them in order!
+  return opts.pwrite  &&  opts.parallel  &&  !opts.demux  &&  !opts.echo  &&
+      !opts.index  &&  !opts.pcapng  &&  !opts.statistics  &&
+      opts.decode.empty()  &&  opts.reorderHorizon.count() == 0;
+}
 
-    const ConstStringIter endDev = std::find(begDev, last, ' ');
-    if( endDev == last ) {
-      logger->logError(lineno, u8"Invalid device separator!");
+bool convertFile(const fs::path& input, const fs::path& output, ParseErrors& errors,
+                 const Options& opts, const cs::LoggerPtr& logger,
+                 std::size_t& numFrames)
+{
+  const parser::ParseFunc parse = parseFunc(opts);
+  const FrameFilter *filter = frameFilter(opts);
+
+  // NOTE: Compressed input cannot be mapped; it is streamed through LineReader.
+  const InputFile::Compression compression = InputFile::detect(input);
+  if( !InputFile::isSupported(compression) ) {
+    logger->logError(u8"Compressed input \"{}\" is not supported by this build!", input);
+    return false;
+  }
+  const bool is_compressed = compression != InputFile::Compression::None;
+
+  if( isPwrite(opts)  &&  !is_compressed ) {
+    MappedFile mapped;
+    if( !mapped.open(input) ) {
+      logger->logError(u8"Unable to map input \"{}\"!", input);
       return false;
     }
 
-    first = endDev;
-
-    result.assign(begDev, endDev);
-
-    return true;
+    ParallelPcapWriter writer(logger, errors, opts.numThreads, parse, filter);
+    writer.setRotation(opts.rotation);
+    const bool ok = writer.write(output, mapped.view(), opts.device);
+    numFrames = writer.numFrames();
+    return ok;
   }
 
-  bool parseId(LineInfo& result, ConstStringIter& first, const ConstStringIter& last,
-               const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    constexpr ConstStringIter::difference_type THREE = 3;
-
-    result.id = 0;
-    result.is_ext = false;
-
-    const ConstStringIter begId = std::find_if_not(first, last, lambda_is_space());
-    if( begId == last ) {
-      logger->logError(lineno, u8"Missing message ID!");
-      return false;
-    }
+  const IFrameSinkPtr sink = createSink(output, opts, logger);
+  if( !sink ) {
+    return false;
+  }
 
-    const ConstStringIter endId = std::find(begId, last, '#');
-    if( endId == last ) {
-      logger->logError(lineno, u8"Invalid ID separator!");
+  if( (opts.mapped  ||  opts.parallel)  &&  !is_compressed ) {
+    MappedFile mapped;
+    if( !mapped.open(input) ) {
+      logger->logError(u8"Unable to map input \"{}\"!", input);
       return false;
     }
 
-    const std::string_view idStr(begId, endId);
-    const auto expVal = cs::toValue<canid_t>(idStr, 16);
-    result.id = expVal.value_or(0);
-    if( !expVal.has_value() ) {
-      logger->logError(lineno, u8"Invalid ID string \"{}\"!", idStr);
-      return false;
+    if( opts.parallel ) {
+      ChunkedParser source(mapped.view(), errors, opts.numThreads, parse, filter);
+      return convertInfos(source, *sink, output, opts, logger, numFrames);
     }
 
-    result.is_ext = std::distance(begId, endId) > THREE  ||  result.id > CAN_SFF_MASK;
+    LineSplitter splitter(mapped.view());
+    parser::LineParser source(splitter, errors, parse, filter);
+    return convertInfos(source, *sink, output, opts, logger, numFrames);
+  }
 
-    first = endId;
-    ++first; // NOTE: consider '#' part of the ID
+  LineReader reader;
+  if( !reader.open(input) ) {
+    logger->logError(u8"Unable to read input \"{}\"!", input);
+    return false;
+  }
 
-    return true;
+  parser::LineParser source(reader, errors, parse, filter);
+  if( !convertInfos(source, *sink, output, opts, logger, numFrames) ) {
+    return false;
   }
 
-  bool parseRawDLC(uint8_t& result, ConstStringIter& first, const ConstStringIter& last,
-                   const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    result = 0;
+  if( reader.isError() ) {
+    logger->logError(u8"Corrupt compressed input \"{}\"!", input);
+    return false;
+  }
 
-    if( first == last  ||  *first != '_' ) {
-      return true;
-    }
+  return true;
+}
 
-    ++first; // Skip '_'
+// NOTE: The parser's messages are reported once the input is done.
+bool convert(const fs::path& input, const fs::path& output,
+             const Options& opts, const cs::LoggerPtr& logger,
+             std::size_t& numFrames)
+{
+  ParseErrors errors;
+  const bool ok = convertFile(input, output, errors, opts, logger, numFrames);
+  errors.report(logger, input);
+  return ok;
+}
 
-    result = cs::fromHexChar(*first);
-    if( result == INVALID_HEXCHAR ) {
-      logger->logError(lineno, u8"Invalid raw DLC \"{}\"!", *first);
+bool merge(const std::vector<fs::path>& inputs, const fs::path& output,
+           const Options& opts, const cs::LoggerPtr& logger,
+           std::size_t& numFrames)
+{
+  MergeSource source(logger, parseFunc(opts), frameFilter(opts));
+  for(const fs::path& input : inputs) {
+    if( !source.add(input) ) {
+      logger->logError(u8"Unable to read input \"{}\"!", input);
       return false;
     }
+  }
 
-    ++first;
+  const IFrameSinkPtr sink = createSink(output, opts, logger);
+  if( !sink ) {
+    return false;
+  }
 
-    return true;
+  if( !convertInfos(source, *sink, output, opts, logger, numFrames) ) {
+    return false;
   }
 
-  std::expected<cs::TimeVal,std::errc> parseTime(const std::string_view& str)
-  {
-    namespace chr = std::chrono;
+  source.reportErrors();
 
-    using      seconds_t = chr::seconds::rep;
-    using microseconds_t = chr::microseconds::rep;
+  if( source.isError() ) {
+    logger->logError(u8"Corrupt compressed input!");
+    return false;
+  }
 
-    using size_type = std::string_view::size_type;
+  return true;
+}
 
-    constexpr size_type NPOS = std::string_view::npos;
-    constexpr size_type  ONE = 1;
+volatile std::sig_atomic_t stopFollowing = 0;
 
-    const size_type idxDot = str.find('.');
-    if( idxDot == NPOS ) {
-      return std::unexpected(std::errc::invalid_argument);
-    }
+extern "C" void requestStop(int /*signal*/)
+{
+  stopFollowing = 1;
+}
 
-    const auto expSecs = cs::toValue<seconds_t>(str.substr(0, idxDot));
-    if( !expSecs.has_value() ) {
-      return std::unexpected(expSecs.error());
-    }
+/*
+ * NOTE: follow() converts the input as it grows, like 'tail -f'; a trailing
+ *       line without ending is held back until it is complete. Converted
+ *       frames are flushed to the output every 'flushInterval'. Following
+ *       ends upon SIGINT/SIGTERM or after 'idleTimeout' without new input
+ *       (if non-zero); a truncated input is followed from its beginning.
+ *
+ * NOTE: Frames held back by the reorder stage are written when following ends.
+ */
+
+bool follow(const fs::path& input, const fs::path& output,
+            const Options& opts, const cs::LoggerPtr& logger)
+{
+  LineReader reader;
+  reader.setFollow(true);
+  if( !reader.open(input) ) {
+    logger->logError(u8"Unable to read input \"{}\"!", input);
+    return false;
+  }
 
-    const auto expUSecs = cs::toValue<microseconds_t>(str.substr(idxDot + ONE));
-    if( !expUSecs.has_value() ) {
-      return std::unexpected(expUSecs.error());
-    }
+  const IFrameSinkPtr sink = createSink(output, opts, logger);
+  if( !sink ) {
+    return false;
+  }
+
+  ParseErrors errors;
+  parser::LineParser source(reader, errors, parseFunc(opts), frameFilter(opts));
 
-    return cs::TimeVal(chr::seconds{expSecs.value()},
-                       chr::microseconds{expUSecs.value()});
+  // NOTE: As with convertInfos(), frames are reordered upon request only.
+  std::optional<ReorderSource<decltype(source)>> reorder;
+  if( opts.reorderHorizon.count() > 0 ) {
+    reorder.emplace(source, opts.reorderHorizon, false);
   }
 
-  bool parseTime(cs::TimeVal& result, ConstStringIter& first, const ConstStringIter& last,
-                 const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    result = cs::TimeVal{-1};
+  const auto getInfo = [&](LineInfo& info) -> bool {
+    return reorder
+        ? reorder->getInfo(info)
+        : source.getInfo(info);
+  };
 
-    if( *first != '(' ) {
-      logger->logError(lineno, u8"Missing time stamp!");
-      return false;
-    }
+  std::signal(SIGINT,  requestStop);
+  std::signal(SIGTERM, requestStop);
 
-    ++first; // parse '('
+  const std::unique_ptr<CandumpWriter> echo = makeEcho(opts);
 
-    const ConstStringIter endTim = std::find(first, last, ')');
-    if( endTim == last ) {
-      logger->logError(lineno, u8"Incomplete time stamp!");
-      return false;
+  const auto writeInfo = [&](const LineInfo& info) -> bool {
+    if( echo ) {
+      echo->write(info);
     }
 
-    const std::string_view timeStr(first, endTim);
-    result = parseTime(timeStr).value_or(cs::TimeVal(-1));
-    if( !result.isValid() ) {
-      logger->logError(lineno, u8"Invalid time stamp \"{}\"!", timeStr);
+    if( !sink->write(info) ) {
+      logger->logError(u8"Unable to write record to \"{}\"!", output);
       return false;
     }
 
-    first = endTim;
-    ++first; // parse ')'
-
     return true;
-  }
+  };
 
-  bool parseType(LineInfo& result, ConstStringIter& first, const ConstStringIter& last,
-                 const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    result.fdflags = 0;
-    result.is_canfd = false;
-    result.is_rtr = false;
-    result.len = 0;
-
-    // (1) Message Type //////////////////////////////////////////////////////
-
-    // NOTE: No message type for empty CAN 2.0 messages!
-    if( first == last ) {
-      return true;
-    }
+  chr::steady_clock::time_point lastFlush = chr::steady_clock::now();
+  chr::steady_clock::time_point lastInput = lastFlush;
+  bool is_dirty = false;
 
-    if(        *first == '#' ) {
-      result.is_canfd = true;
-      ++first;
+  LineInfo info;
+  while( stopFollowing == 0 ) {
+    const LineReader::size_type offset = reader.offset();
 
-    } else if( *first == 'R' ) {
-      result.is_rtr = true;
-      ++first;
+    while( getInfo(info) ) {
+      if( !writeInfo(info) ) {
+        return false;
+      }
 
-    } else if( cs::isHexDigit(*first) ) {
-      return true;
+      is_dirty = true;
+    } // For Each Complete Line
 
-    } else {
-      logger->logError(lineno, u8"Invalid message type \"{}\"!", *first);
-      return false;
+    const chr::steady_clock::time_point now = chr::steady_clock::now();
 
+    const bool is_input = reader.offset() != offset;
+    if( is_input ) {
+      lastInput = now;
     }
 
-    // (2) Message Extra /////////////////////////////////////////////////////
-
-    if( first == last ) {
-      if( result.is_rtr ) {
-        return true;
-      } else {
-        logger->logError(lineno, u8"Missing message extra!");
+    if( is_dirty  &&  now - lastFlush >= opts.flushInterval ) {
+      if( !sink->flush() ) {
+        logger->logError(u8"Unable to write record to \"{}\"!", output);
         return false;
       }
-    }
 
-    const uint8_t extra = cs::fromHexChar(*first);
-    if( extra == INVALID_HEXCHAR ) {
-      logger->logError(lineno, u8"Invalid message extra \"{}\"!", *first);
-      return false;
+      lastFlush = now;
+      is_dirty = false;
     }
 
-    if(        result.is_canfd ) {
-      result.fdflags = extra;
-    } else if( result.is_rtr ) {
-      result.len = extra;
+    if( reader.isTruncated() ) {
+      logger->logWarning(u8"Input \"{}\" was truncated; following from its beginning.", input);
+      if( !reader.open(input) ) {
+        logger->logError(u8"Unable to read input \"{}\"!", input);
+        break;
+      }
+      continue;
     }
 
-    ++first;
-
-    return true;
-  }
+    if( opts.idleTimeout.count() > 0  &&  now - lastInput >= opts.idleTimeout ) {
+      break;
+    }
 
-  LineInfo parseLine(ConstStringIter first, const ConstStringIter& last,
-                     const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    LineInfo info;
+    if( !is_input ) {
+      // NOTE: Show echoed frames and the parser's messages while waiting for more input.
+      if( echo ) {
+        echo->flush();
+      }
 
-    // (0) Sanity Check ////////////////////////////////////////////////////////
+      errors.report(logger, input);
+      errors.clear();
 
-    if( first == last ) {
-      logger->logWarning(lineno, u8"Ignoring empty line!");
-      return LineInfo();
+      std::this_thread::sleep_for(opts.pollInterval);
     }
+  } // Follow
 
-    if( *first != '(' ) {
-      logger->logWarning(lineno, u8"Ignoring line with invalid start sequence \"{}\"!", *first);
-      return LineInfo();
+  if( reorder ) {
+    reorder->setDrain(true);
+    while( reorder->getInfo(info) ) {
+      if( !writeInfo(info) ) {
+        return false;
+      }
     }
+  }
 
-    // (1) Time Stamp //////////////////////////////////////////////////////////
+  errors.report(logger, input);
+  if( reorder ) {
+    warnLate(reorder->numLate(), output, logger);
+  }
 
-    if( !parseTime(info.time, first, last, logger, lineno) ) {
-      return LineInfo();
-    }
+  if( !sink->close() ) {
+    logger->logError(u8"Unable to write record to \"{}\"!", output);
+    return false;
+  }
 
-    // (2) Device //////////////////////////////////////////////////////////////
+  return true;
+}
 
-    if( !parseDevice(info.device, first, last, logger, lineno) ) {
-      return LineInfo();
-    }
 
-    // (3) Message ID ////////////////////////////////////////////////////////
+////// Command Line //////////////////////////////////////////////////////////
 
-    if( !parseId(info, first, last, logger, lineno) ) {
-      return LineInfo();
-    }
+void printUsage()
+{
+  std::println("Usage: log2pcap [options] <input>...");
+  std::println("");
+  std::println("Converts candump logs to pcap files. An input is either a log file, a");
+  std::println("directory (all *.log files) or a wildcard pattern (e.g. \"logs/*.log\").");
+  std::println("Logs compressed with gzip (*.log.gz) or zstd (*.log.zst) are read directly.");
+  std::println("");
+  std::println("Input/Output:");
+  std::println("  -h, --help                Show this help.");
+  std::println("  -j, --jobs <n>            Number of files converted concurrently.");
+  std::println("  -o, --output <file>       Output file (single input or --merge).");
+  std::println("  -O, --output-dir <dir>    Directory of the output files.");
+  std::println("  -r, --recursive           Scan input directories recursively.");
+  std::println("      --echo                Print every converted frame.");
+  std::println("");
+  std::println("Parsing:");
+  std::println("      --lexer               Use the lexer instead of the parser.");
+  std::println("      --mapped              Map the input into memory.");
+  std::println("      --parallel            Parse chunks of the input concurrently.");
+  std::println("  -t, --threads <n>         Number of threads of --parallel.");
+  std::println("");
+  std::println("Filtering:");
+  std::println("      --device <name>       Write frames of <name> only (default: vcan0);");
+  std::println("                            an empty <name> writes all devices.");
+  std::println("      --filter-device <name>  Accept frames of device <name>.");
+  std::println("      --filter-id <spec>    Accept IDs \"id\", \"id:mask\", \"id~mask\" or \"first-last\".");
+  std::println("      --from <time>         Accept frames at or after <time> (secs.usecs).");
+  std::println("      --to <time>           Accept frames before <time> (secs.usecs).");
+  std::println("");
+  std::println("Output:");
+  std::println("      --demux               Write one pcap file per device.");
+  std::println("      --index               Write a seek index alongside each pcap file.");
+  std::println("      --pcapng              Write pcapng instead of pcap.");
+  std::println("      --nanoseconds         Use nanosecond time stamps in pcapng.");
+  std::println("      --pwrite              Write records concurrently (requires --parallel).");
+  std::println("      --split-size <MB>     Start a new pcap file before exceeding <MB> (10^6 bytes).");
+  std::println("      --split-time <s>      Start a new pcap file after <s> of frames.");
+  std::println("      --stats               Write bus statistics instead of frames.");
+  std::println("      --bitrate <bps>       Nominal bitrate of --stats (default: 500000).");
+  std::println("      --data-bitrate <bps>  Data bitrate of --stats (default: 2000000).");
+  std::println("      --decode <file>       Write the signals of the Encode(...) definitions of <file>.");
+  std::println("      --decode-format <fmt> Format of --decode: \"csv\" (default) or \"bin\".");
+  std::println("");
+  std::println("Ordering:");
+  std::println("      --reorder <ms>        Restore the time order of frames within <ms>.");
+  std::println("");
+  std::println("Modes:");
+  std::println("      --merge               Merge all inputs by time into one output.");
+  std::println("      --follow              Convert a single growing input like 'tail -f'.");
+  std::println("      --flush-interval <ms> Flush interval of --follow (default: 1000).");
+  std::println("      --idle-timeout <s>    Stop --follow without input for <s> (default: 0).");
+  std::println("      --poll-interval <ms>  Poll interval of --follow (default: 250).");
+}
 
-    // (4) Message Type: CAN 2.0, RTR, CAN FD ////////////////////////////////
+template<typename T>
+bool toNumber(T& result, const std::string_view& arg, const std::string_view& value,
+              const cs::LoggerPtr& logger)
+{
+  const auto expVal = cs::toValue<T>(value);
+  if( !expVal ) {
+    logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+    return false;
+  }
 
-    if( !parseType(info, first, last, logger, lineno) ) {
-      return LineInfo();
-    }
+  result = expVal.value();
 
-    // (5) Parse Data ////////////////////////////////////////////////////////
+  return true;
+}
 
-    if( !info.is_rtr  &&  !parseData(info, first, last, logger, lineno) ) {
-      return LineInfo();
+bool parseArgs(Options& opts, const int argc, char **argv, const cs::LoggerPtr& logger)
+{
+  constexpr std::size_t NPOS = std::string_view::npos;
+
+  cs::TimeVal from{-1};
+  cs::TimeVal to{-1};
+
+  for(int i = 1; i < argc; i++) {
+    std::string_view arg(argv[i]);
+    std::string_view value;
+    bool has_value = false;
+    bool is_used = false;
+
+    // NOTE: Long options accept "--name=value" as well as "--name value";
+    //       short options accept "-nvalue" as well as "-n value".
+    if(        arg.starts_with("--") ) {
+      const std::size_t pos = arg.find('=');
+      if( pos != NPOS ) {
+        value = arg.substr(pos + 1);
+        arg = arg.substr(0, pos);
+        has_value = true;
+      }
+    } else if( arg.starts_with("-")  &&  arg.size() > 2 ) {
+      value = arg.substr(2);
+      arg = arg.substr(0, 2);
+      has_value = true;
     }
 
-    // (6) Parse Raw DLC /////////////////////////////////////////////////////
+    const auto getValue = [&]() -> bool {
+      if( !has_value ) {
+        if( i + 1 >= argc ) {
+          logger->logError(u8"Missing value of option \"{}\"!", arg);
+          return false;
+        }
+        value = argv[++i];
+      }
+      is_used = true;
+      return true;
+    };
 
-    if( !parseRawDLC(info.len8_dlc, first, last, logger, lineno) ) {
-      return LineInfo();
+    bool ok = true;
+    if(        !arg.starts_with("-") ) {
+      opts.inputs.emplace_back(arg);
+    } else if( arg == "-h"  ||  arg == "--help" ) {
+      opts.help = true;
+    } else if( arg == "-j"  ||  arg == "--jobs" ) {
+      ok = getValue()  &&  toNumber(opts.numJobs, arg, value, logger);
+    } else if( arg == "-o"  ||  arg == "--output" ) {
+      ok = getValue();
+      opts.output = value;
+    } else if( arg == "-O"  ||  arg == "--output-dir" ) {
+      ok = getValue();
+      opts.outputDir = value;
+    } else if( arg == "-r"  ||  arg == "--recursive" ) {
+      opts.recursive = true;
+    } else if( arg == "--echo" ) {
+      opts.echo = true;
+    } else if( arg == "--lexer" ) {
+      opts.lexer = true;
+    } else if( arg == "--mapped" ) {
+      opts.mapped = true;
+    } else if( arg == "--parallel" ) {
+      opts.parallel = true;
+    } else if( arg == "-t"  ||  arg == "--threads" ) {
+      ok = getValue()  &&  toNumber(opts.numThreads, arg, value, logger);
+    } else if( arg == "--device" ) {
+      ok = getValue();
+      opts.device = value;
+    } else if( arg == "--filter-device" ) {
+      ok = getValue();
+      opts.filter.addDevice(value);
+    } else if( arg == "--filter-id" ) {
+      ok = getValue();
+      if( ok  &&  !opts.filter.addId(value) ) {
+        logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+        ok = false;
+      }
+    } else if( arg == "--from"  ||  arg == "--to" ) {
+      ok = getValue();
+      if( ok ) {
+        const std::expected<cs::TimeVal,std::errc> time = parser::parseTime(value);
+        if( !time ) {
+          logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+          ok = false;
+        } else if( arg == "--from" ) {
+          from = time.value();
+        } else {
+          to = time.value();
+        }
+      }
+    } else if( arg == "--demux" ) {
+      opts.demux = true;
+    } else if( arg == "--index" ) {
+      opts.index = true;
+    } else if( arg == "--pcapng" ) {
+      opts.pcapng = true;
+    } else if( arg == "--nanoseconds" ) {
+      opts.nanoseconds = true;
+    } else if( arg == "--pwrite" ) {
+      opts.pwrite = true;
+    } else if( arg == "--split-size" ) {
+      std::size_t mb = 0;
+      ok = getValue()  &&  toNumber(mb, arg, value, logger);
+      opts.rotation.maxBytes = mb*1000*1000;
+    } else if( arg == "--split-time" ) {
+      std::size_t s = 0;
+      ok = getValue()  &&  toNumber(s, arg, value, logger);
+      opts.rotation.maxSpan = chr::seconds(s);
+    } else if( arg == "--stats" ) {
+      opts.statistics = true;
+    } else if( arg == "--bitrate" ) {
+      ok = getValue()  &&  toNumber(opts.timing.bitrate, arg, value, logger);
+    } else if( arg == "--data-bitrate" ) {
+      ok = getValue()  &&  toNumber(opts.timing.dataBitrate, arg, value, logger);
+    } else if( arg == "--decode" ) {
+      ok = getValue();
+      opts.decode = value;
+    } else if( arg == "--decode-format" ) {
+      ok = getValue();
+      if(        value == "csv" ) {
+        opts.decodeFormat = SignalFormat::Csv;
+      } else if( value == "bin" ) {
+        opts.decodeFormat = SignalFormat::Binary;
+      } else if( ok ) {
+        logger->logError(u8"Invalid value \"{}\" of option \"{}\"!", value, arg);
+        ok = false;
+      }
+    } else if( arg == "--merge" ) {
+      opts.merge = true;
+    } else if( arg == "--follow" ) {
+      opts.follow = true;
+    } else if( arg == "--flush-interval" ) {
+      std::size_t ms = 0;
+      ok = getValue()  &&  toNumber(ms, arg, value, logger);
+      opts.flushInterval = chr::milliseconds(ms);
+    } else if( arg == "--idle-timeout" ) {
+      std::size_t s = 0;
+      ok = getValue()  &&  toNumber(s, arg, value, logger);
+      opts.idleTimeout = chr::seconds(s);
+    } else if( arg == "--poll-interval" ) {
+      std::size_t ms = 0;
+      ok = getValue()  &&  toNumber(ms, arg, value, logger);
+      opts.pollInterval = chr::milliseconds(ms);
+    } else if( arg == "--reorder" ) {
+      std::size_t ms = 0;
+      ok = getValue()  &&  toNumber(ms, arg, value, logger);
+      opts.reorderHorizon = chr::milliseconds(ms);
+    } else {
+      logger->logError(u8"Unknown option \"{}\"!", arg);
+      ok = false;
     }
 
-    return info;
-  }
-
-  LineInfo parseLine(const std::string& line,
-                     const cs::LoggerPtr& logger, const std::size_t lineno)
-  {
-    return parseLine(line.begin(), line.end(), logger, lineno);
-  }
+    if( ok  &&  has_value  &&  !is_used ) {
+      logger->logError(u8"Option \"{}\" takes no value!", arg);
+      ok = false;
+    }
 
-} // namespace parser
+    if( !ok ) {
+      return false;
+    }
+  } // For Each Argument
 
-namespace writer {
+  opts.filter.setWindow(from, to);
 
-  bool writeHeader(const cs::File& file)
-  {
-    constexpr auto SIZE_HEADER = sizeof(pcap_hdr);
+  return true;
+}
 
-    pcap_hdr header;
-    memset(&header, 0, SIZE_HEADER);
+////// Inputs ////////////////////////////////////////////////////////////////
 
-    /*
-     * NOTE: cf. to the following link for the value of '.snaplen':
-     *
-     * https://www.wireshark.org/docs/wsug_html_chunked/AppToolstcpdump.html
-     */
+/*
+ * NOTE: Wildcards are supported in the file name only: '*' matches any
+ *       sequence of characters, '?' matches any single character.
+ */
 
-    header.magic_number  = MAGIC_NUMBER;
-    header.version_major = VERSION_MAJOR;
-    header.version_minor = VERSION_MINOR;
-    header.snaplen       = 65535;
-    header.network       = LINKTYPE_CAN_SOCKETCAN;
+bool isWildcard(const std::string_view& pattern)
+{
+  return pattern.find_first_of("*?") != std::string_view::npos;
+}
 
-    return file.write(&header, SIZE_HEADER) == SIZE_HEADER;
+bool matchWildcard(const std::string_view& pattern, const std::string_view& name)
+{
+  constexpr std::size_t NPOS = std::string_view::npos;
+
+  std::size_t idxPat  = 0;
+  std::size_t idxName = 0;
+  std::size_t star    = NPOS;
+  std::size_t resume  = 0;
+
+  while( idxName < name.size() ) {
+    if(        idxPat < pattern.size()  &&
+               (pattern[idxPat] == '?'  ||  pattern[idxPat] == name[idxName]) ) {
+      idxPat++;
+      idxName++;
+    } else if( idxPat < pattern.size()  &&  pattern[idxPat] == '*' ) {
+      star   = idxPat++;
+      resume = idxName;
+    } else if( star != NPOS ) {
+      // NOTE: Backtrack; let the last '*' consume one more character.
+      idxPat  = star + 1;
+      idxName = ++resume;
+    } else {
+      return false;
+    }
   }
 
-  bool write(const cs::File& file, const LineInfo& info)
-  {
-    constexpr auto SIZE_HEADER = sizeof(pcaprec_hdr);
+  while( idxPat < pattern.size()  &&  pattern[idxPat] == '*' ) {
+    idxPat++;
+  }
 
-    pcaprec_hdr header;
-    memset(&header, 0, SIZE_HEADER);
+  return idxPat == pattern.size();
+}
 
-    header.ts_sec   = info.time.secs().count();
-    header.ts_usec  = info.time.usecs().count();
-    header.incl_len = CAN_MTU;
-    header.orig_len = CAN_MTU;
+// NOTE: Input directories are scanned for plain and compressed logs.
+constexpr std::array<std::string_view,3> LOG_PATTERNS{"*.log", "*.log.gz", "*.log.zst"};
 
-    if( file.write(&header, SIZE_HEADER) != SIZE_HEADER ) {
-      return false;
+template<typename IteratorT>
+void collectFiles(std::vector<fs::path>& result, IteratorT iter,
+                  const std::span<const std::string_view>& patterns)
+{
+  std::error_code ec;
+  for(const fs::directory_entry& entry : iter) {
+    if( !entry.is_regular_file(ec) ) {
+      continue;
     }
 
-    can_frame frame;
-    memset(&frame, 0, CAN_MTU);
-
-    frame.can_id = info.id;
-    frame.len    = info.len;
-
-    if( info.is_ext ) {
-      frame.can_id |= CAN_EFF_FLAG;
+    const std::string name = entry.path().filename().string();
+    if( std::any_of(patterns.begin(), patterns.end(), [&](const std::string_view& pattern) -> bool {
+          return matchWildcard(pattern, name);
+        }) ) {
+      result.push_back(entry.path());
     }
+  }
+}
 
-    if( info.is_rtr ) {
-      frame.can_id |= CAN_RTR_FLAG;
+bool expandInputs(std::vector<fs::path>& result,
+                  const Options& opts, const cs::LoggerPtr& logger)
+{
+  result.clear();
+
+  for(const std::string& arg : opts.inputs) {
+    const fs::path path(arg);
+
+    std::vector<fs::path> files;
+    std::error_code ec;
+    if(        isWildcard(path.filename().string()) ) {
+      const fs::path dir = path.has_parent_path()
+          ? path.parent_path()
+          : fs::path(".");
+      const std::string pattern = path.filename().string();
+      const std::string_view view(pattern);
+      collectFiles(files, fs::directory_iterator(dir, ec), std::span(&view, 1));
+    } else if( fs::is_directory(path, ec) ) {
+      if( opts.recursive ) {
+        collectFiles(files, fs::recursive_directory_iterator(path, ec), LOG_PATTERNS);
+      } else {
+        collectFiles(files, fs::directory_iterator(path, ec), LOG_PATTERNS);
+      }
+    } else if( fs::is_regular_file(path, ec) ) {
+      files.push_back(path);
+    } else {
+      logger->logError(u8"Input \"{}\" not found!", path);
+      return false;
     }
 
-    if( info.isLen8Dlc() ) {
-      frame.len8_dlc = info.len8_dlc;
+    if( files.empty() ) {
+      logger->logWarning(u8"No input matches \"{}\"!", path);
+      continue;
     }
 
-    if( !info.is_rtr ) {
-      for(uint8_t i = 0; i < frame.len; i++) {
-        frame.data[i] = info.data[i];
+    // NOTE: Rotated logs sort by time; convert them in this order.
+    std::sort(files.begin(), files.end());
+
+    for(const fs::path& file : files) {
+      if( std::find(result.cbegin(), result.cend(), file) == result.cend() ) {
+        result.push_back(file);
       }
     }
+  } // For Each Argument
 
-    return file.write(&frame, CAN_MTU) == CAN_MTU;
-  }
+  return true;
+}
 
-  bool writeFD(const cs::File& file, const LineInfo& info)
-  {
-    constexpr auto SIZE_HEADER = sizeof(pcaprec_hdr);
+fs::path outputPath(const fs::path& input, const Options& opts)
+{
+  if( !opts.output.empty() ) {
+    return opts.output;
+  }
 
-    pcaprec_hdr header;
-    memset(&header, 0, SIZE_HEADER);
+  // NOTE: "name.log.gz" becomes "name.pcap".
+  fs::path stem = input;
+  if( input.extension() == ".gz"  ||  input.extension() == ".zst" ) {
+    stem.replace_extension();
+  }
 
-    header.ts_sec   = info.time.secs().count();
-    header.ts_usec  = info.time.usecs().count();
-    header.incl_len = CANFD_MTU;
-    header.orig_len = CANFD_MTU;
+  const fs::path output = replaceExtension(stem, outputExtension(opts));
+  if( !opts.outputDir.empty() ) {
+    return opts.outputDir / output.filename();
+  }
 
-    if( file.write(&header, SIZE_HEADER) != SIZE_HEADER ) {
-      return false;
-    }
+  return output;
+}
 
-    canfd_frame frame;
-    memset(&frame, 0, CANFD_MTU);
+////// Batch Conversion //////////////////////////////////////////////////////
 
-    frame.can_id = info.id;
-    frame.len    = info.len;
-    frame.flags  = info.fdflags;
+struct Job {
+  std::vector<fs::path>       inputs;
+  fs::path                    output;
+  chr::steady_clock::duration elapsed{0};
+  std::uintmax_t              numBytes{0};
+  std::size_t                 numFrames{0};
+  bool                        ok{false};
+};
 
-    if( info.is_ext ) {
-      frame.can_id |= CAN_EFF_FLAG;
-    }
+/*
+ * NOTE: Jobs run concurrently and truncate their output upon opening it;
+ *       hence, no two jobs may share an output, and no output may be an
+ *       input. Paths are compared after resolving symbolic links.
+ */
 
-    for(uint8_t i = 0; i < frame.len; i++) {
-      frame.data[i] = info.data[i];
+bool checkOutputs(const std::vector<Job>& jobs, const cs::LoggerPtr& logger)
+{
+  const auto normalize = [](const fs::path& path) -> fs::path {
+    std::error_code ec;
+    const fs::path result = fs::weakly_canonical(path, ec);
+    return !ec
+        ? result
+        : fs::absolute(path, ec).lexically_normal();
+  };
+
+  std::set<fs::path> inputs;
+  for(const Job& job : jobs) {
+    for(const fs::path& input : job.inputs) {
+      inputs.insert(normalize(input));
     }
-
-    return file.write(&frame, CANFD_MTU) == CANFD_MTU;
   }
 
-  void write(const fs::path& output, const LineInfos& infos, const std::string& device,
-             const cs::LoggerPtr& logger)
-  {
-    const cs::File::OpenFlags flags = cs::FileOpenFlag::Write | cs::FileOpenFlag::Truncate;
-    cs::File file;
-    if( !file.open(output, flags) ) {
-      logger->logError(u8"Unable to open file \"{}\"!", output);
-      return;
+  bool ok = true;
+  std::set<fs::path> outputs;
+  for(const Job& job : jobs) {
+    const fs::path output = normalize(job.output);
+    if(        inputs.contains(output) ) {
+      logger->logError(u8"Output \"{}\" would overwrite an input!", job.output);
+      ok = false;
+    } else if( !outputs.insert(output).second ) {
+      logger->logError(u8"Output \"{}\" is shared by several inputs!", job.output);
+      ok = false;
     }
+  }
 
-    writeHeader(file); // TODO
-
-    for(const LineInfo& info : infos) {
-      if( info.device != device ) {
-        continue;
-      }
+  return ok;
+}
 
-      if( info.is_canfd ) {
-        writeFD(file, info); // TODO
-      } else {
-        write(file, info); // TODO
-      }
+void runJob(Job& job, const Options& opts, const cs::LoggerPtr& logger)
+{
+  job.numBytes = 0;
+  for(const fs::path& input : job.inputs) {
+    std::error_code ec;
+    const std::uintmax_t size = fs::file_size(input, ec);
+    if( !ec ) {
+      job.numBytes += size;
     }
-
-    file.close();
   }
 
-} // namespace writer
+  const chr::steady_clock::time_point start = chr::steady_clock::now();
 
-inline fs::path replaceExtension(fs::path p, const fs::path& ext)
-{
-  p.replace_extension(ext);
-  return p;
+  job.ok = opts.merge
+      ? merge(job.inputs, job.output, opts, logger, job.numFrames)
+      : convert(job.inputs.front(), job.output, opts, logger, job.numFrames);
+
+  job.elapsed = chr::steady_clock::now() - start;
 }
 
-void print(const LineInfo& info)
-{  
-  std::print("({}.{}) ", info.time.secs().count(), info.time.usecs().count());
+/*
+ * NOTE: runJobs() converts up to 'numJobs' files concurrently; the calling
+ *       thread is one of the workers. Each job may itself use 'numThreads'
+ *       threads with --parallel!
+ */
 
-  std::print("{} ", info.device);
+void runJobs(std::vector<Job>& jobs, const Options& opts, const cs::LoggerPtr& logger)
+{
+  std::atomic<std::size_t> next{0};
 
-  if( info.is_ext ) {
-    std::print("{:08X}#", info.id);
-  } else {
-    std::print("{:X}#", info.id);
+  const auto worker = [&]() -> void {
+    for(std::size_t i = next++; i < jobs.size(); i = next++) {
+      runJob(jobs[i], opts, logger);
+    }
+  };
+
+  const std::size_t numJobs = opts.numJobs > 0
+      ? opts.numJobs
+      : ChunkedParser::defaultThreads();
+  const std::size_t numWorkers = std::min(numJobs, jobs.size());
+
+  std::vector<std::thread> workers;
+  for(std::size_t i = 1; i < numWorkers; i++) {
+    try {
+      workers.emplace_back(worker);
+    } catch(...) {
+      break;
+    }
   }
 
-  if( info.is_canfd ) {
-    std::print("#{:X}", info.fdflags);
-  }
+  worker();
 
-  if( info.is_rtr ) {
-    std::print("R{:X}", info.len);
-  } else {
-    for(uint8_t i = 0; i < info.len; i++) {
-      std::print("{:02X}", info.data[i]);
-    }
+  for(std::thread& thread : workers) {
+    thread.join();
   }
+}
 
-  if( info.isLen8Dlc() ) {
-    std::print("_{:X}", info.len8_dlc);
+void printReport(const std::vector<Job>& jobs, const chr::steady_clock::duration elapsed)
+{
+  using Seconds = chr::duration<double>;
+
+  constexpr double MEGA = 1000.0*1000.0;
+
+  const auto rate = [](const double value, const double secs) -> double {
+    return secs > 0
+        ? value/secs
+        : 0;
+  };
+
+  std::uintmax_t numBytes = 0;
+  std::size_t   numFrames = 0;
+  std::size_t   numFailed = 0;
+  for(const Job& job : jobs) {
+    const double secs = chr::duration_cast<Seconds>(job.elapsed).count();
+
+    // NOTE: Merged inputs are reported by their common output.
+    const fs::path& name = job.inputs.size() == 1
+        ? job.inputs.front()
+        : job.output;
+
+    std::println("{}: {} frames in {:.3f} s ({:.0f} frames/s, {:.1f} MB/s){}",
+                 name, job.numFrames, secs,
+                 rate(double(job.numFrames), secs), rate(double(job.numBytes)/MEGA, secs),
+                 job.ok ? "" : " FAILED");
+
+    numBytes  += job.numBytes;
+    numFrames += job.numFrames;
+    numFailed += job.ok ? 0 : 1;
   }
 
-  std::println("");
-}
+  const double secs = chr::duration_cast<Seconds>(elapsed).count();
 
-void printno(const std::size_t lineno, const LineInfo& info)
-{
-  std::print("{}: ", lineno);
-  print(info);
+  std::println("Total: {} file(s), {} failed, {} frames in {:.3f} s ({:.0f} frames/s, {:.1f} MB/s)",
+               jobs.size(), numFailed, numFrames, secs,
+               rate(double(numFrames), secs), rate(double(numBytes)/MEGA, secs));
 }
 
-int main(int /*argc*/, char **argv)
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int argc, char **argv)
 {
   cs::LoggerPtr logger = cs::Logger::make();
 
-  const fs::path input = "./testdata/candump-2024-09-01_173152.log";
-  if( !cs::isFile(input) ) {
-    logger->logError(u8"Input \"{}\" not found!", input);
+  Options opts;
+  if( !parseArgs(opts, argc, argv, logger) ) {
     return EXIT_FAILURE;
   }
 
-  const chr::system_clock::time_point inputTime = cs::lastWriteTime(input);
-  const cs::TimeVal inputTimeVal(inputTime);
-  std::println("{}.{} {}", inputTimeVal.secs(), inputTimeVal.usecs(), inputTimeVal.value());
+  if( opts.help  ||  opts.inputs.empty() ) {
+    printUsage();
+    return opts.help
+        ? EXIT_SUCCESS
+        : EXIT_FAILURE;
+  }
 
-  const fs::path output = replaceExtension(input, "pcap");
-  std::println("{} -> {}", input, output);
+  std::vector<fs::path> inputs;
+  if( !expandInputs(inputs, opts, logger) ) {
+    return EXIT_FAILURE;
+  }
 
-  const std::list<std::string> lines = cs::readLines(input);
-  if( lines.empty() ) {
-    logger->logError(u8"Unable to read input \"{}\"!", input);
+  if( inputs.empty() ) {
+    logger->logError(u8"No input!");
     return EXIT_FAILURE;
   }
 
-  LineInfos infos;
+  if( !opts.output.empty()  &&  inputs.size() > 1  &&  !opts.merge ) {
+    logger->logError(u8"Option \"--output\" requires a single input or \"--merge\"!");
+    return EXIT_FAILURE;
+  }
 
-  std::size_t lineno = 0;
-  for(const std::string& line : lines) {
-    lineno += 1;
+  // NOTE: Pieces are plain pcap files; cf. RotatingSink.
+  if( opts.rotation.isEnabled()  &&  (opts.demux  ||  opts.pcapng  ||  opts.statistics) ) {
+    logger->logError(u8"Options \"--split-size\" and \"--split-time\" require pcap output!");
+    return EXIT_FAILURE;
+  }
 
-    const LineInfo info = parser::parseLine(line, logger, lineno);
-    if( !info.isValid() ) {
-      continue;
+  // NOTE: Decoded signals replace the frames; cf. SignalSink.
+  if( !opts.decode.empty() ) {
+    if( opts.demux  ||  opts.index  ||  opts.pcapng  ||  opts.statistics  ||
+        opts.rotation.isEnabled() ) {
+      logger->logError(u8"Option \"--decode\" cannot be combined with other outputs!");
+      return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<SignalDecoder> decoder = std::make_shared<SignalDecoder>();
+    if( !decoder->load(opts.decode, logger) ) {
+      return EXIT_FAILURE;
+    }
+    opts.decoder = std::move(decoder);
+  }
+
+  if( !opts.outputDir.empty() ) {
+    std::error_code ec;
+    fs::create_directories(opts.outputDir, ec);
+    if( ec ) {
+      logger->logError(u8"Unable to create directory \"{}\"!", opts.outputDir);
+      return EXIT_FAILURE;
     }
+  }
 
-    infos.push_back(info);
+  std::vector<Job> jobs;
+  if( opts.merge ) {
+    Job& job = jobs.emplace_back();
+    job.inputs = inputs;
+    job.output = outputPath(inputs.front(), opts);
+  } else {
+    for(const fs::path& input : inputs) {
+      Job& job = jobs.emplace_back();
+      job.inputs.push_back(input);
+      job.output = outputPath(input, opts);
+    }
+  }
 
-#if 0
-    if( lineno <= 40 ) {
-      printno(lineno, info);
+  if( !checkOutputs(jobs, logger) ) {
+    return EXIT_FAILURE;
+  }
+
+  if( opts.follow ) {
+    if( inputs.size() != 1 ) {
+      logger->logError(u8"Option \"--follow\" requires a single input!");
+      return EXIT_FAILURE;
+    }
+
+    if( InputFile::detect(inputs.front()) != InputFile::Compression::None ) {
+      logger->logError(u8"Option \"--follow\" requires an uncompressed input!");
+      return EXIT_FAILURE;
     }
-#endif
-  } // For Each Line
 
-#if 1
-  std::for_each(infos.cbegin(), infos.cend(), print);
-#else
-  std::for_each(infos.cbegin(), std::next(infos.cbegin(), 40), print);
-#endif
+    return follow(jobs.front().inputs.front(), jobs.front().output, opts, logger)
+        ? EXIT_SUCCESS
+        : EXIT_FAILURE;
+  }
+
+  // NOTE: Echoed frames of concurrent jobs would interleave.
+  if( opts.echo ) {
+    opts.numJobs = 1;
+  }
+
+  const chr::steady_clock::time_point start = chr::steady_clock::now();
+  runJobs(jobs, opts, logger);
+  printReport(jobs, chr::steady_clock::now() - start);
 
-  writer::write(output, infos, "vcan0", logger);
+  const bool ok = std::all_of(jobs.cbegin(), jobs.cend(), [](const Job& job) -> bool {
+    return job.ok;
+  });
 
-  return EXIT_SUCCESS;
+  return ok
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
 }
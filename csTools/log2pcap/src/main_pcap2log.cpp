@@ -0,0 +1,191 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <filesystem>
+#include <print>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <cs/Logging/Logger.h>
+#include <cs/System/PathFormatter.h>
+
+#include "CandumpWriter.h"
+#include "PcapReader.h"
+
+namespace fs = std::filesystem;
+
+struct Options {
+  std::vector<fs::path> inputs;
+  fs::path              output;
+  std::string           device{"vcan0"};
+  bool                  help{false};
+};
+
+void printUsage()
+{
+  std::println("Usage: pcap2log [options] <input>...");
+  std::println("");
+  std::println("Converts pcap and pcapng files of SocketCAN frames to candump logs.");
+  std::println("");
+  std::println("  -h, --help                Show this help.");
+  std::println("  -o, --output <file>       Output file (default: standard output).");
+  std::println("      --device <name>       Device of pcap frames (default: vcan0).");
+}
+
+bool parseArgs(Options& opts, const int argc, char **argv, const cs::LoggerPtr& logger)
+{
+  for(int i = 1; i < argc; i++) {
+    const std::string_view arg(argv[i]);
+
+    const bool is_value = arg == "-o"  ||  arg == "--output"  ||  arg == "--device";
+    if( is_value  &&  i + 1 >= argc ) {
+      logger->logError(u8"Missing value of option \"{}\"!", arg);
+      return false;
+    }
+
+    if(        !arg.starts_with("-") ) {
+      opts.inputs.emplace_back(arg);
+    } else if( arg == "-h"  ||  arg == "--help" ) {
+      opts.help = true;
+    } else if( arg == "-o"  ||  arg == "--output" ) {
+      opts.output = argv[++i];
+    } else if( arg == "--device" ) {
+      opts.device = argv[++i];
+    } else {
+      logger->logError(u8"Unknown option \"{}\"!", arg);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool checkOutput(const Options& opts, const cs::LoggerPtr& logger)
+{
+  if( opts.output.empty() ) {
+    return true;
+  }
+
+  const auto normalize = [](const fs::path& path) -> fs::path {
+    std::error_code ec;
+    const fs::path result = fs::weakly_canonical(path, ec);
+    return !ec
+        ? result
+        : fs::absolute(path, ec).lexically_normal();
+  };
+
+  const fs::path output = normalize(opts.output);
+  for(const fs::path& input : opts.inputs) {
+    if( normalize(input) == output ) {
+      logger->logError(u8"Output \"{}\" would overwrite an input!", opts.output);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool convert(const fs::path& input, CandumpWriter& writer,
+             const Options& opts, const cs::LoggerPtr& logger)
+{
+  PcapReader reader(logger);
+  if( !reader.open(input, opts.device) ) {
+    logger->logError(u8"Unable to read pcap \"{}\"!", input);
+    return false;
+  }
+
+  LineInfo info;
+  while( reader.getInfo(info) ) {
+    if( !writer.write(info) ) {
+      logger->logError(u8"Unable to write output!");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  cs::LoggerPtr logger = cs::Logger::make();
+
+  Options opts;
+  if( !parseArgs(opts, argc, argv, logger) ) {
+    return EXIT_FAILURE;
+  }
+
+  if( opts.help  ||  opts.inputs.empty() ) {
+    printUsage();
+    return opts.help
+        ? EXIT_SUCCESS
+        : EXIT_FAILURE;
+  }
+
+  if( !checkOutput(opts, logger) ) {
+    return EXIT_FAILURE;
+  }
+
+  std::FILE *stream = stdout;
+  if( !opts.output.empty() ) {
+    stream = std::fopen(opts.output.string().c_str(), "wb");
+    if( stream == nullptr ) {
+      logger->logError(u8"Unable to open file \"{}\"!", opts.output);
+      return EXIT_FAILURE;
+    }
+  }
+
+  bool ok = true;
+  {
+    CandumpWriter writer(stream);
+    for(const fs::path& input : opts.inputs) {
+      ok = convert(input, writer, opts, logger)  &&  ok;
+    }
+
+    if( !writer.flush() ) {
+      logger->logError(u8"Unable to write output!");
+      ok = false;
+    }
+  }
+
+  if( stream != stdout  &&  std::fclose(stream) != 0 ) {
+    logger->logError(u8"Unable to write file \"{}\"!", opts.output);
+    ok = false;
+  }
+
+  return ok
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "FrameFilter.h"
+#include "IFrameSink.h"
+#include "ParseErrors.h"
+
+////// Test Data /////////////////////////////////////////////////////////////
+
+/*
+ * NOTE: makeCandump() generates a reproducible candump log of 'numFrames'
+ *       lines: classic, remote and CAN FD frames of standard and extended
+ *       IDs on several devices, with timestamps slightly out of order and
+ *       a few malformed lines.
+ */
+
+std::string makeCandump(const std::size_t numFrames, const uint32_t seed);
+
+std::string readFile(const std::filesystem::path& path);
+
+std::filesystem::path testPath(const std::string_view& name);
+
+bool writeFile(const std::filesystem::path& path, const std::string_view& data);
+
+// NOTE: Sequential parsing and writing is the reference of all tests.
+bool writeSerial(IFrameSink& sink, const std::string_view& text,
+                 const FrameFilter *filter = nullptr);
+
+bool writeSerial(IFrameSink& sink, const std::string_view& text,
+                 ParseErrors& errors, const FrameFilter *filter = nullptr);
+
+////// Results ///////////////////////////////////////////////////////////////
+
+bool check(const bool ok, const std::string_view& what);
+
+////// Tests /////////////////////////////////////////////////////////////////
+
+bool run_archive_tests();
+
+bool run_index_tests();
+
+bool run_parallel_tests();
+
+bool run_rotation_tests();
@@ -0,0 +1,189 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <print>
+#include <random>
+#include <system_error>
+
+#include "tests.h"
+
+#include "LineSplitter.h"
+#include "Parser.h"
+
+////// Test Data /////////////////////////////////////////////////////////////
+
+std::string makeCandump(const std::size_t numFrames, const uint32_t seed)
+{
+  constexpr int64_t USECS_PER_SEC = 1000000;
+
+  constexpr const char *DEVICES[] = {"can0", "can1", "vcan0"};
+  constexpr std::size_t NUM_DEVICES = sizeof(DEVICES)/sizeof(DEVICES[0]);
+
+  constexpr std::size_t FD_LENGTHS[] = {0, 1, 8, 12, 16, 20, 24, 32, 48, 64};
+  constexpr std::size_t NUM_FD_LENGTHS = sizeof(FD_LENGTHS)/sizeof(FD_LENGTHS[0]);
+
+  std::mt19937 rng(seed);
+
+  std::string text;
+  std::back_insert_iterator<std::string> out(text);
+
+  int64_t time = int64_t{1725204743}*USECS_PER_SEC;
+  for(std::size_t i = 0; i < numFrames; i++) {
+    time += rng()%2000;
+
+    if( rng()%512 == 0 ) {
+      text += "not a candump line\n";
+      continue;
+    }
+
+    // NOTE: Every 16th frame is logged up to 5ms late.
+    int64_t stamp = time;
+    if( rng()%16 == 0 ) {
+      stamp -= rng()%5000;
+    }
+
+    const char *device = DEVICES[rng()%NUM_DEVICES];
+
+    const bool is_ext = rng()%4 == 0;
+    const uint32_t id = is_ext
+        ? rng() & 0x1FFFFFFF
+        : rng() & 0x7FF;
+
+    std::format_to(out, "({}.{:06}) {} ", stamp/USECS_PER_SEC, stamp%USECS_PER_SEC, device);
+    if( is_ext ) {
+      std::format_to(out, "{:08X}", id);
+    } else {
+      std::format_to(out, "{:03X}", id);
+    }
+
+    const uint32_t kind = rng()%8;
+    if(        kind == 0 ) {
+      std::format_to(out, "#R{}", rng()%9);
+    } else if( kind <= 2 ) {
+      std::format_to(out, "##{:X}", rng()%4);
+      const std::size_t len = FD_LENGTHS[rng()%NUM_FD_LENGTHS];
+      for(std::size_t j = 0; j < len; j++) {
+        std::format_to(out, "{:02X}", rng()%256);
+      }
+    } else {
+      text += '#';
+      const std::size_t len = rng()%9;
+      for(std::size_t j = 0; j < len; j++) {
+        std::format_to(out, "{:02X}", rng()%256);
+      }
+      if( len == 8  &&  rng()%4 == 0 ) {
+        std::format_to(out, "_{:X}", 9 + rng()%7);
+      }
+    }
+
+    text += '\n';
+  }
+
+  return text;
+}
+
+std::string readFile(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::filesystem::path testPath(const std::string_view& name)
+{
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "log2pcaptests";
+
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+
+  return dir / name;
+}
+
+bool writeFile(const std::filesystem::path& path, const std::string_view& data)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(data.data(), static_cast<std::streamsize>(data.size()));
+  return file.good();
+}
+
+bool writeSerial(IFrameSink& sink, const std::string_view& text,
+                 const FrameFilter *filter)
+{
+  ParseErrors errors;
+  return writeSerial(sink, text, errors, filter);
+}
+
+bool writeSerial(IFrameSink& sink, const std::string_view& text,
+                 ParseErrors& errors, const FrameFilter *filter)
+{
+  LineSplitter splitter(text);
+  parser::LineParser source(splitter, errors, parser::parseLine, filter);
+
+  LineInfo info;
+  while( source.getInfo(info) ) {
+    if( !sink.write(info) ) {
+      return false;
+    }
+  }
+
+  return sink.close();
+}
+
+////// Results ///////////////////////////////////////////////////////////////
+
+bool check(const bool ok, const std::string_view& what)
+{
+  std::println("{}: {}", what, ok ? "OK" : "not OK");
+  return ok;
+}
+
+////// Main //////////////////////////////////////////////////////////////////
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  bool ok = true;
+
+  ok = run_archive_tests()   &&  ok;
+  ok = run_index_tests()     &&  ok;
+  ok = run_parallel_tests()  &&  ok;
+  ok = run_rotation_tests()  &&  ok;
+
+  std::fflush(stdout);
+
+  return ok
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
+}
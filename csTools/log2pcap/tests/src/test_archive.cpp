@@ -0,0 +1,193 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+
+#include "tests.h"
+
+#include "ArchiveReader.h"
+#include "ArchiveSink.h"
+#include "CandumpWriter.h"
+#include "LineSplitter.h"
+#include "Parser.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace test_query {
+
+  using size_type = std::size_t;
+
+  // NOTE: Small blocks allow skipping most of them.
+  constexpr size_type BLOCK_FRAMES = 256;
+
+  constexpr int64_t USECS_PER_SEC = 1000000;
+
+  constexpr int64_t TIME_START = int64_t{1725204743}*USECS_PER_SEC;
+
+  // NOTE: Equivalent to "log2pcap --echo": Print all frames passing 'filter'.
+  bool echo(const std::filesystem::path& output, const std::string_view& text,
+            const FrameFilter *filter)
+  {
+    std::FILE *stream = std::fopen(output.string().c_str(), "wb");
+    if( stream == nullptr ) {
+      return false;
+    }
+
+    bool ok = true;
+    {
+      ParseErrors errors;
+      LineSplitter splitter(text);
+      parser::LineParser source(splitter, errors, parser::parseLine, filter);
+
+      CandumpWriter writer(stream);
+
+      LineInfo info;
+      while( ok  &&  source.getInfo(info) ) {
+        ok = writer.write(info);
+      }
+      ok = writer.flush()  &&  ok;
+    }
+
+    return std::fclose(stream) == 0  &&  ok;
+  }
+
+  // NOTE: Equivalent to "canarchive --query": Print all frames passing 'filter'.
+  bool query(const std::filesystem::path& output, ArchiveReader& reader,
+             const FrameFilter *filter)
+  {
+    std::FILE *stream = std::fopen(output.string().c_str(), "wb");
+    if( stream == nullptr ) {
+      return false;
+    }
+
+    reader.setFilter(filter);
+
+    bool ok = true;
+    {
+      CandumpWriter writer(stream);
+
+      LineInfo info;
+      while( ok  &&  reader.getInfo(info) ) {
+        ok = writer.write(info);
+      }
+      ok = writer.flush()  &&  ok  &&  !reader.isError();
+    }
+
+    return std::fclose(stream) == 0  &&  ok;
+  }
+
+  bool checkQuery(const std::filesystem::path& archive, const std::string_view& text,
+                  const FrameFilter *filter, const bool is_skipping,
+                  const std::string_view& what)
+  {
+    const std::filesystem::path pathEcho  = testPath("archive-echo.log");
+    const std::filesystem::path pathQuery = testPath("archive-query.log");
+
+    if( !echo(pathEcho, text, filter) ) {
+      return check(false, std::format("{}: echo", what));
+    }
+
+    ArchiveReader reader;
+    if( !reader.open(archive)  ||  !query(pathQuery, reader, filter) ) {
+      return check(false, std::format("{}: query", what));
+    }
+
+    const std::string expected = readFile(pathEcho);
+    bool ok = check(readFile(pathQuery) == expected  &&  !expected.empty(),
+                    std::format("{}: query == echo", what));
+
+    if( is_skipping ) {
+      ok = check(reader.numBlocksRead() < reader.numBlocks(),
+                 std::format("{}: blocks skipped", what))  &&  ok;
+    }
+
+    return ok;
+  }
+
+} // namespace test_query
+
+////// Tests /////////////////////////////////////////////////////////////////
+
+bool run_archive_tests()
+{
+  using namespace test_query;
+
+  const std::string text = makeCandump(50000, 11);
+
+  const std::filesystem::path archive = testPath("archive.canarc");
+  {
+    const IFrameSinkPtr sink = ArchiveSink::create(archive, BLOCK_FRAMES);
+    if( !sink  ||  !writeSerial(*sink, text) ) {
+      return check(false, "archive: write");
+    }
+  }
+
+  bool ok = true;
+
+  ok = checkQuery(archive, text, nullptr, false, "archive")  &&  ok;
+
+  {
+    FrameFilter filter;
+    filter.addDevice("can1");
+    ok = checkQuery(archive, text, &filter, false, "archive device")  &&  ok;
+  }
+
+  {
+    FrameFilter filter;
+    filter.addRange(0x100, 0x1FF);
+    filter.addId(0x12345678, CAN_EFF_FLAG | CAN_EFF_MASK);
+    ok = checkQuery(archive, text, &filter, false, "archive IDs")  &&  ok;
+  }
+
+  // NOTE: The log starts at TIME_START and spans about 50s.
+  {
+    FrameFilter filter;
+    filter.setWindow(cs::TimeVal{TIME_START + 10*USECS_PER_SEC},
+                     cs::TimeVal{TIME_START + 12*USECS_PER_SEC});
+    ok = checkQuery(archive, text, &filter, true, "archive window")  &&  ok;
+  }
+
+  {
+    FrameFilter filter;
+    filter.addDevice("vcan0");
+    filter.addRange(0x000, 0x3FF);
+    filter.setWindow(cs::TimeVal{TIME_START + 20*USECS_PER_SEC},
+                     cs::TimeVal{TIME_START + 30*USECS_PER_SEC});
+    ok = checkQuery(archive, text, &filter, true, "archive combined")  &&  ok;
+  }
+
+  return ok;
+}
@@ -0,0 +1,211 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <filesystem>
+#include <format>
+#include <string>
+#include <vector>
+
+#include "tests.h"
+
+#include "PCAP.h"
+#include "PcapIndex.h"
+#include "PcapRangeReader.h"
+#include "PcapSink.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace test_index {
+
+  constexpr int64_t USECS_PER_SEC = 1000000;
+
+  struct Record {
+    uint64_t offset{0};
+    int64_t  time{0};
+
+    bool operator==(const Record&) const = default;
+  };
+
+  using Records = std::vector<Record>;
+
+  // NOTE: The reference is a full scan of the pcap file's records.
+  Records scanRecords(const std::string& pcap, const int64_t from, const int64_t to)
+  {
+    Records result;
+
+    std::size_t pos = sizeof(pcap_hdr);
+    while( pos + sizeof(pcaprec_hdr) <= pcap.size() ) {
+      pcaprec_hdr header;
+      memcpy(&header, pcap.data() + pos, sizeof(pcaprec_hdr));
+
+      const int64_t time = int64_t{header.ts_sec}*USECS_PER_SEC + int64_t{header.ts_usec};
+      if( from <= time  &&  time < to ) {
+        result.push_back({pos, time});
+      }
+
+      pos += sizeof(pcaprec_hdr) + header.incl_len;
+    }
+
+    return result;
+  }
+
+  Records readRecords(PcapRangeReader& reader, const int64_t from, const int64_t to)
+  {
+    reader.setRange(cs::TimeVal{from}, cs::TimeVal{to});
+
+    Records result;
+
+    PcapRecord record;
+    while( reader.getRecord(record) ) {
+      result.push_back({record.offset, record.time.value()});
+    }
+
+    return result;
+  }
+
+  // NOTE: Windows around the first and last record, single time stamps,
+  //       empty windows and a window of a few seconds in the middle.
+  std::vector<std::pair<int64_t,int64_t>> makeWindows(const std::string& pcap)
+  {
+    const Records all = scanRecords(pcap, PcapIndex::MIN_TIME, PcapIndex::MAX_TIME);
+
+    int64_t first = PcapIndex::MAX_TIME;
+    int64_t last  = PcapIndex::MIN_TIME;
+    for(const Record& record : all) {
+      first = std::min(first, record.time);
+      last  = std::max(last,  record.time);
+    }
+
+    const int64_t middle = all[all.size()/2].time;
+
+    return {
+      {PcapIndex::MIN_TIME, PcapIndex::MAX_TIME},
+      {first, last},
+      {first, last + 1},
+      {first - USECS_PER_SEC, first},
+      {last + 1, last + USECS_PER_SEC},
+      {middle, middle},
+      {middle, middle + 1},
+      {middle - 2*USECS_PER_SEC, middle + 3*USECS_PER_SEC},
+      {middle - 5000, middle + 5000}
+    };
+  }
+
+  bool checkWindows(const std::filesystem::path& path, const bool is_indexed,
+                    const std::string_view& what)
+  {
+    const std::string pcap = readFile(path);
+
+    PcapRangeReader reader;
+    if( !reader.open(path) ) {
+      return check(false, std::format("{}: open", what));
+    }
+
+    bool ok = check(reader.index().blocks().empty() != is_indexed,
+                    std::format("{}: {}", what, is_indexed ? "sidecar used" : "sidecar ignored"));
+
+    for(const std::pair<int64_t,int64_t>& window : makeWindows(pcap)) {
+      const Records expected = scanRecords(pcap, window.first, window.second);
+      const Records actual   = readRecords(reader, window.first, window.second);
+
+      ok = check(actual == expected,
+                 std::format("{}: [{},{}) {} records", what,
+                             window.first, window.second, expected.size()))  &&  ok;
+    }
+
+    return ok;
+  }
+
+  bool writeIndexed(const std::filesystem::path& path, const std::string& text)
+  {
+    const IFrameSinkPtr sink = PcapSink::create(path, std::string(), true);
+    return sink  &&  writeSerial(*sink, text);
+  }
+
+} // namespace test_index
+
+////// Tests /////////////////////////////////////////////////////////////////
+
+bool run_index_tests()
+{
+  using namespace test_index;
+
+  namespace fs = std::filesystem;
+
+  const fs::path path    = testPath("index.pcap");
+  const fs::path sidecar = PcapIndex::sidecarPath(path);
+
+  const std::string text = makeCandump(50000, 13);
+
+  bool ok = true;
+
+  // (1) Sidecar of the pcap file ////////////////////////////////////////////
+
+  ok = check(writeIndexed(path, text), "index: write")  &&  ok;
+  ok = checkWindows(path, true, "index")  &&  ok;
+
+  // (2) No sidecar //////////////////////////////////////////////////////////
+
+  const fs::path plain = testPath("index-plain.pcap");
+  std::error_code ec;
+  fs::copy_file(path, plain, fs::copy_options::overwrite_existing, ec);
+  fs::remove(PcapIndex::sidecarPath(plain), ec);
+
+  ok = checkWindows(plain, false, "index without sidecar")  &&  ok;
+
+  // (3) Stale sidecar of a pcap file of the same size ///////////////////////
+
+  const std::string oldSidecar = readFile(sidecar);
+
+  std::string pcap = readFile(path);
+  std::size_t pos = sizeof(pcap_hdr);
+  while( pos + sizeof(pcaprec_hdr) <= pcap.size() ) {
+    pcaprec_hdr header;
+    memcpy(&header, pcap.data() + pos, sizeof(pcaprec_hdr));
+    header.ts_sec += 3600;
+    memcpy(pcap.data() + pos, &header, sizeof(pcaprec_hdr));
+    pos += sizeof(pcaprec_hdr) + header.incl_len;
+  }
+  ok = check(writeFile(path, pcap), "index: rewrite")  &&  ok;
+
+  ok = checkWindows(path, false, "index with stale sidecar (same size)")  &&  ok;
+
+  // (4) Stale sidecar of a larger pcap file /////////////////////////////////
+
+  ok = check(writeIndexed(path, text + makeCandump(1000, 17)), "index: regenerate")  &&  ok;
+  ok = check(writeFile(sidecar, oldSidecar), "index: restore sidecar")  &&  ok;
+
+  ok = checkWindows(path, false, "index with stale sidecar (larger)")  &&  ok;
+
+  return ok;
+}
@@ -0,0 +1,203 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cs/Logging/Logger.h>
+
+#include "tests.h"
+
+#include "ChunkedParser.h"
+#include "LineSplitter.h"
+#include "ParallelPcapWriter.h"
+#include "PcapSink.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace test_parallel {
+
+  using size_type = std::size_t;
+
+  // NOTE: Chunks of a few KiB split the input into hundreds of chunks.
+  constexpr size_type CHUNK_SIZE  = 4096;
+  constexpr size_type NUM_THREADS = 4;
+
+  /*
+   * NOTE: checkLine() parses like parser::parseLine(), but verifies the line
+   *       number reported for each line against the lines of the input.
+   */
+
+  std::vector<std::string_view> lines;
+  std::atomic<size_type>        numWrongLines{0};
+
+  LineInfo checkLine(const std::string_view& line, ParseErrors& errors,
+                     const size_type lineno, const FrameFilter *filter)
+  {
+    if( lineno == 0  ||  lineno > lines.size()  ||  lines[lineno - 1] != line ) {
+      numWrongLines++;
+    }
+    return parser::parseLine(line, errors, lineno, filter);
+  }
+
+  void splitLines(const std::string_view& text)
+  {
+    lines.clear();
+
+    LineSplitter splitter(text);
+    std::string_view line;
+    while( splitter.getLine(line) ) {
+      lines.push_back(line);
+    }
+  }
+
+  bool isEqual(const ParseErrors& a, const ParseErrors& b)
+  {
+    for(size_type i = 0; i < ParseErrors::NUM_CATEGORIES; i++) {
+      const ParseErrors::Category category = static_cast<ParseErrors::Category>(i);
+      if( a.count(category) != b.count(category) ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool writeChunked(const std::filesystem::path& path, const std::string_view& text,
+                    ParseErrors& errors, const std::string& device,
+                    const FrameFilter *filter)
+  {
+    const IFrameSinkPtr sink = PcapSink::create(path, device);
+    if( !sink ) {
+      return false;
+    }
+
+    ChunkedParser source(text, errors, NUM_THREADS, checkLine, filter, CHUNK_SIZE);
+
+    LineInfo info;
+    while( source.getInfo(info) ) {
+      if( !sink->write(info) ) {
+        return false;
+      }
+    }
+
+    return sink->close();
+  }
+
+  bool writeParallel(const std::filesystem::path& path, const std::string_view& text,
+                     ParseErrors& errors, const std::string& device,
+                     const FrameFilter *filter)
+  {
+    ParallelPcapWriter writer(cs::Logger::make(), errors, NUM_THREADS,
+                              checkLine, filter, CHUNK_SIZE);
+    return writer.write(path, text, device);
+  }
+
+  bool checkParallel(const std::string_view& text, const std::string& device,
+                     const FrameFilter *filter, const std::string_view& what)
+  {
+    const std::filesystem::path pathSerial   = testPath("parallel-serial.pcap");
+    const std::filesystem::path pathChunked  = testPath("parallel-chunked.pcap");
+    const std::filesystem::path pathParallel = testPath("parallel-pwrite.pcap");
+
+    splitLines(text);
+    numWrongLines = 0;
+
+    // (1) Reference /////////////////////////////////////////////////////////
+
+    ParseErrors errorsSerial;
+    {
+      const IFrameSinkPtr sink = PcapSink::create(pathSerial, device);
+      if( !sink  ||  !writeSerial(*sink, text, errorsSerial, filter) ) {
+        return check(false, std::format("{}: serial", what));
+      }
+    }
+
+    const std::string serial = readFile(pathSerial);
+
+    // (2) Chunked parsing ///////////////////////////////////////////////////
+
+    ParseErrors errorsChunked;
+    bool ok = check(writeChunked(pathChunked, text, errorsChunked, device, filter)  &&
+                    readFile(pathChunked) == serial,
+                    std::format("{}: chunked == serial", what));
+    ok = check(isEqual(errorsChunked, errorsSerial),
+               std::format("{}: chunked errors == serial errors", what))  &&  ok;
+
+    // (3) Parallel writing //////////////////////////////////////////////////
+
+    ParseErrors errorsParallel;
+    ok = check(writeParallel(pathParallel, text, errorsParallel, device, filter)  &&
+               readFile(pathParallel) == serial,
+               std::format("{}: pwrite == serial", what))  &&  ok;
+    ok = check(isEqual(errorsParallel, errorsSerial),
+               std::format("{}: pwrite errors == serial errors", what))  &&  ok;
+
+    ok = check(numWrongLines == 0, std::format("{}: line numbers", what))  &&  ok;
+
+    return ok;
+  }
+
+} // namespace test_parallel
+
+////// Tests /////////////////////////////////////////////////////////////////
+
+bool run_parallel_tests()
+{
+  using namespace test_parallel;
+
+  const std::string text = makeCandump(100000, 3);
+
+  bool ok = true;
+
+  ok = checkParallel(text, std::string(), nullptr, "parallel")  &&  ok;
+  ok = checkParallel(text, "vcan0", nullptr, "parallel vcan0")  &&  ok;
+
+  FrameFilter filter;
+  filter.addRange(0x100, 0x3FF);
+  filter.addDevice("can1");
+  ok = checkParallel(text, std::string(), &filter, "parallel filtered")  &&  ok;
+
+  // NOTE: A final line without end of line.
+  ok = checkParallel(std::string_view(text).substr(0, text.size() - 1), std::string(), nullptr,
+                     "parallel without final end of line")  &&  ok;
+
+  // NOTE: Less input than a single chunk.
+  ok = checkParallel(std::string_view(text).substr(0, CHUNK_SIZE/2), std::string(), nullptr,
+                     "parallel single chunk")  &&  ok;
+
+  ok = checkParallel(std::string_view(), std::string(), nullptr, "parallel empty")  &&  ok;
+
+  return ok;
+}
@@ -0,0 +1,188 @@
+/****************************************************************************
+** Copyright (c) 2024, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+
+#include <cs/Logging/Logger.h>
+
+#include "tests.h"
+
+#include "PCAP.h"
+#include "ParallelPcapWriter.h"
+#include "PcapSink.h"
+#include "RotatingSink.h"
+#include "Rotation.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace test_rotation {
+
+  using size_type = std::size_t;
+
+  void removePieces(const std::filesystem::path& output)
+  {
+    std::error_code ec;
+    for(size_type i = 0; std::filesystem::remove(Rotation::piecePath(output, i), ec); i++) {
+    }
+  }
+
+  /*
+   * NOTE: concatPieces() returns the records of all pieces of 'output'; each
+   *       piece has to start with a pcap_hdr and must not exceed 'maxBytes'.
+   */
+
+  bool concatPieces(std::string& records, size_type& numPieces,
+                    const std::filesystem::path& output, const size_type maxBytes)
+  {
+    records.clear();
+    numPieces = 0;
+
+    for(;; numPieces++) {
+      const std::filesystem::path path = Rotation::piecePath(output, numPieces);
+      if( !std::filesystem::exists(path) ) {
+        break;
+      }
+
+      const std::string piece = readFile(path);
+      if( piece.size() <= sizeof(pcap_hdr) ) {
+        return false;
+      }
+      if( maxBytes > 0  &&  piece.size() > maxBytes ) {
+        return false;
+      }
+
+      records.append(piece, sizeof(pcap_hdr));
+    }
+
+    return numPieces > 0;
+  }
+
+  bool checkRotation(const std::string_view& text, const Rotation& rotation,
+                     const std::string_view& what)
+  {
+    const std::filesystem::path pathWhole    = testPath("rotation-whole.pcap");
+    const std::filesystem::path pathSerial   = testPath("rotation-serial.pcap");
+    const std::filesystem::path pathParallel = testPath("rotation-pwrite.pcap");
+
+    removePieces(pathSerial);
+    removePieces(pathParallel);
+
+    // (1) Reference /////////////////////////////////////////////////////////
+
+    {
+      const IFrameSinkPtr sink = PcapSink::create(pathWhole);
+      if( !sink  ||  !writeSerial(*sink, text) ) {
+        return check(false, std::format("{}: unsplit", what));
+      }
+    }
+
+    const std::string whole = readFile(pathWhole);
+    const std::string records = whole.size() >= sizeof(pcap_hdr)
+        ? whole.substr(sizeof(pcap_hdr))
+        : std::string();
+
+    // (2) RotatingSink //////////////////////////////////////////////////////
+
+    {
+      const IFrameSinkPtr sink = RotatingSink::create(pathSerial, rotation);
+      if( !sink  ||  !writeSerial(*sink, text) ) {
+        return check(false, std::format("{}: serial", what));
+      }
+    }
+
+    std::string serial;
+    size_type numSerial = 0;
+    bool ok = check(concatPieces(serial, numSerial, pathSerial, rotation.maxBytes)  &&
+                    numSerial > 1  &&  serial == records,
+                    std::format("{}: pieces == unsplit", what));
+
+    // (3) Parallel writing //////////////////////////////////////////////////
+
+    {
+      ParseErrors errors;
+      ParallelPcapWriter writer(cs::Logger::make(), errors, 4,
+                                parser::parseLine, nullptr, 4096);
+      writer.setRotation(rotation);
+      if( !writer.write(pathParallel, text) ) {
+        return check(false, std::format("{}: pwrite", what))  &&  ok;
+      }
+    }
+
+    std::string parallel;
+    size_type numParallel = 0;
+    bool okParallel = concatPieces(parallel, numParallel, pathParallel, rotation.maxBytes)  &&
+        numParallel == numSerial  &&  parallel == records;
+    for(size_type i = 0; okParallel  &&  i < numSerial; i++) {
+      okParallel = readFile(Rotation::piecePath(pathParallel, i)) ==
+          readFile(Rotation::piecePath(pathSerial, i));
+    }
+    ok = check(okParallel, std::format("{}: pwrite pieces == serial pieces", what))  &&  ok;
+
+    return ok;
+  }
+
+} // namespace test_rotation
+
+////// Tests /////////////////////////////////////////////////////////////////
+
+bool run_rotation_tests()
+{
+  using namespace test_rotation;
+
+  const std::string text = makeCandump(50000, 7);
+
+  bool ok = true;
+
+  {
+    Rotation rotation;
+    rotation.maxBytes = 64*1024;
+    ok = checkRotation(text, rotation, "rotation bytes")  &&  ok;
+  }
+
+  {
+    Rotation rotation;
+    rotation.maxSpan = std::chrono::seconds{3};
+    ok = checkRotation(text, rotation, "rotation span")  &&  ok;
+  }
+
+  {
+    Rotation rotation;
+    rotation.maxBytes = 100*1024;
+    rotation.maxSpan  = std::chrono::seconds{2};
+    ok = checkRotation(text, rotation, "rotation bytes & span")  &&  ok;
+  }
+
+  return ok;
+}